@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+
+"""
+Compare two result files written by
+`benchmarksuite --output <file>`.
+Exits with 1 if any benchmark regressed
+by more than the threshold.
+"""
+
+import argparse
+import json
+import shutil
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {entry["name"]: entry for entry in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="stored results (JSON)")
+    parser.add_argument("current", help="new results (JSON)")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="relative slowdown counted as regression (default: 0.1 = 10%%)",
+    )
+    parser.add_argument(
+        "--metric",
+        choices=["median_ns", "min_ns", "mean_ns"],
+        default="median_ns",
+    )
+    parser.add_argument(
+        "--update-baseline",
+        action="store_true",
+        help="copy current results to baseline afterwards",
+    )
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    mismatched = []
+    print(f"{'benchmark':<60} {'baseline us':>12} {'current us':>12} {'change':>8}")
+    for name, entry in current.items():
+        now = entry[args.metric]
+        if name not in baseline:
+            print(f"{name:<60} {'-':>12} {now / 1000:>12.1f} {'new':>8}")
+            continue
+        before = baseline[name][args.metric]
+        if baseline[name].get("repetitions") != entry.get("repetitions"):
+            mismatched.append(name)
+        change = (now - before) / before if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = " REGRESSION"
+            regressions.append(name)
+        print(f"{name:<60} {before / 1000:>12.1f} {now / 1000:>12.1f} {change:>+8.1%}{flag}")
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<60} {'':>12} {'-':>12} {'missing':>8}")
+
+    if mismatched:
+        print(
+            f"\nwarning: {len(mismatched)} benchmark(s) ran with a different"
+            " number of repetitions than the baseline (e.g. `--quick`),"
+            " the comparison is unreliable."
+        )
+
+    if args.update_baseline:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"baseline updated: {args.baseline}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) above {args.threshold:.0%}:")
+        for name in regressions:
+            print(f"  {name}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
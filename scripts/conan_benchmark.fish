@@ -5,8 +5,25 @@ set BASE_DIR (dirname (status dirname))
 set BUILD_TYPE Debug
 set BUILD_DIR $BASE_DIR/build/conan/$BUILD_TYPE
 
+# repetitions per benchmark, the median is compared
+# (ctest only runs a `--quick` smoke test):
+set REPETITIONS 10
+
 # build
 $BASE_DIR/scripts/conan_build.fish --target build_tests
 and begin
-	ctest --test-dir $BUILD_DIR/tests --tests-regex 'benchmark' --extra-verbose
+	ctest --test-dir $BUILD_DIR/tests --tests-regex 'modelbenchmark' --extra-verbose
+end
+and begin
+	$BUILD_DIR/tests/benchmarksuite \
+		--repetitions $REPETITIONS \
+		--output $BUILD_DIR/tests/benchmarks_full.json
+end
+# compare with baseline (if any),
+# e.g. `--threshold 0.05` or `--update-baseline`:
+and if test -f $BASE_DIR/benchmarks/baseline.json
+	$BASE_DIR/scripts/compare_benchmarks.py \
+		$BASE_DIR/benchmarks/baseline.json \
+		$BUILD_DIR/tests/benchmarks_full.json \
+		$argv
 end
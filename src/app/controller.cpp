@@ -27,6 +27,7 @@ Controller::Controller(
 	, maybeJack(maybeJack)
 	, viewResolution(viewResolution)
 {
+	FGE_TRACE_THREAD( "GUI" );
 
 	// INITIALIZE:
 
@@ -48,12 +49,12 @@ Controller::Controller(
 		&MainWindow::functionCountChanged,
 		this,
 		[this]( uint value ) {
-			modelUpdateQueue->write( this, "resize",
-					[value](auto model) {
-						auto oldSize = model->size();
-						model->resize( value );
-						model->postSetAny();
-						return oldSize;
+			modelUpdateQueue->writeAsync( this, "resize",
+					[value](auto model, auto resolve) {
+						model->resizeAsync( value, [model,resolve](auto oldSize) {
+								model->postSetAny();
+								resolve( oldSize );
+						});
 					},
 					[this](auto model, auto oldSize) {
 						resizeView( model, oldSize );
@@ -100,8 +101,24 @@ Controller::Controller(
 							view->setPlaybackTime( pos );
 						}
 				);
-				const auto stats = this->maybeJack->getStatistics();
-				this->view->setStatistics( stats );
+				modelUpdateQueue->read( this,
+						[](auto model) {
+							return std::make_pair(
+									model->getNodeStatistics(),
+									model->getSamplerate()
+							);
+						},
+						[view = this->view](auto model, auto statistics){
+							view->setNodeStatistics( statistics.first, statistics.second );
+						}
+				);
+				{
+					// lock free, doesn't block the audio thread:
+					auto stats = this->maybeJack->getStatistics();
+					stats.silentBlocks = modelUpdateQueue->getSilentBlockCount();
+					this->view->setStatistics( stats );
+				}
+				updateAnalyzers();
 			}
 		);
 	}
@@ -139,6 +156,7 @@ void Controller::writeDoneCallback(
 		std::function<void()> doneCallback
 )
 {
+	FGE_TRACE_SCOPE( "gui", "update view" );
 	doneCallback();
 }
 
@@ -147,6 +165,10 @@ void Controller::resizeView(
 		const uint oldSize
 ) {
 	view->resizeFunctionView( model->size() );
+	// the taps of removed entries are gone:
+	std::erase_if( analyzers, [model](const auto& entry) {
+			return entry.first >= model->size();
+	});
 	// initialize and connect new entries:
 	for( uint index=oldSize; index<model->size(); index++ ) {
 		// INITIALIZE:
@@ -162,11 +184,11 @@ void Controller::resizeView(
 				&FunctionView::changed,
 				this,
 				[this,index](auto updateInfo) {
-					modelUpdateQueue->write(
+					modelUpdateQueue->writeAsync(
 							this,
 							"update",
-							[index,updateInfo](auto model){
-								return model->bulkUpdate(index,
+							[index,updateInfo](auto model, auto resolve){
+								model->bulkUpdateAsync(index,
 									Model::Update{
 										.formula = updateInfo.formula,
 										.parameters = updateInfo.parameters,
@@ -175,7 +197,8 @@ void Controller::resizeView(
 										.playbackSettings = updateInfo.playbackSettings,
 										.playbackEnabled = updateInfo.playbackEnabled,
 										.samplingSettings = updateInfo.samplingSettings
-									}
+									},
+									resolve
 								);
 							},
 							[this,index,updateInfo](auto model, auto maybeError){
@@ -256,6 +279,14 @@ void Controller::resizeView(
 				);
 			}
 		);
+		connect(
+			functionView,
+			&FunctionView::spectrumSettingsChanged,
+			this,
+			[this,index](auto settings) {
+				setAnalyzer( index, settings );
+			}
+		);
 		// view -> modelUpdateQueue
 		connect(
 			functionView,
@@ -291,6 +322,7 @@ void Controller::setViewFormula(
 }
 
 void Controller::setViewGraph(const Model* model, const uint iFunction) {
+	FGE_TRACE_SCOPE( "gui", "setViewGraph" );
 	const auto functionView = view->getFunctionView(iFunction);
 	auto errorOrPoints = model->getGraph(
 			iFunction,
@@ -305,8 +337,8 @@ void Controller::setViewGraph(const Model* model, const uint iFunction) {
 
 void Controller::startPlayback()
 {
-	modelUpdateQueue->write( this, "setAudioSchedulingEnabled(true)",
-			[maybeJack = this->maybeJack](auto model){
+	modelUpdateQueue->writeAsync( this, "setAudioSchedulingEnabled(true)",
+			[maybeJack = this->maybeJack](auto model, auto resolve){
 				if( maybeJack ) {
 					auto maybeError = maybeJack->start(
 							Callbacks{
@@ -321,12 +353,14 @@ void Controller::startPlayback()
 							}
 					);
 					if( !maybeError ) {
-							model->setAudioSchedulingEnabled(true);
+							model->setAudioSchedulingEnabledAsync(true, resolve);
+							return;
 					}
 				}
 				else {
 					qWarning() << "WARNING: No jack client. Failed to start playback.";
 				}
+				resolve();
 			},
 			[this](auto){
 				modelUpdateQueue->startTimer();
@@ -350,12 +384,63 @@ std::future<void> Controller::stopPlayback()
 				}
 				promise->set_value();
 			},
-			[this](auto) {
+			[this](auto model) {
 				if( this->maybeJack ) {
-					const auto stats = maybeJack->getStatistics();
+					auto stats = maybeJack->getStatistics();
+					stats.silentBlocks = model->getSilentBlockCount();
 					this->view->setStatistics( stats );
 				}
 			}
 	);
 	return future;
 }
+
+void Controller::setAnalyzer(
+		const uint iFunction,
+		const SpectrumSettings& settings
+)
+{
+	if( !settings.enabled ) {
+		if( analyzers.erase( iFunction ) ) {
+			modelUpdateQueue->write( this, "setSampleTap",
+					[iFunction](auto model) {
+						model->setSampleTap( iFunction, nullptr );
+					},
+					[](auto){}
+			);
+		}
+		return;
+	}
+	auto& analyzer = analyzers[iFunction];
+	analyzer.stft = std::make_unique<STFT>( settings );
+	if( !analyzer.tap ) {
+		// big enough to bridge several ticks:
+		analyzer.tap = std::make_shared<SampleTap>( 1 << 16 );
+		modelUpdateQueue->write( this, "setSampleTap",
+				[iFunction, tap = analyzer.tap](auto model) {
+					model->setSampleTap( iFunction, tap );
+				},
+				[](auto){}
+		);
+	}
+	else {
+		analyzer.tap->clear();
+	}
+}
+
+void Controller::updateAnalyzers()
+{
+	analysisBuffer.resize( 4096 );
+	for( auto& [index, analyzer] : analyzers ) {
+		auto functionView = view->getFunctionView(index);
+		size_t count = 0;
+		while( (count = analyzer.tap->pop( analysisBuffer.data(), analysisBuffer.size() )) > 0 ) {
+			analyzer.stft->process(
+					analysisBuffer.data(), count,
+					[functionView](const auto& frame) {
+						functionView->addSpectrumFrame( frame );
+					}
+			);
+		}
+	}
+}
@@ -3,8 +3,10 @@
 
 #include "application.h"
 #include "fge/model/model.h"
+#include "fge/model/stft.h"
 #include "fge/view/mainwindow.h"
 #include "fge/audio/jack.h"
+#include "fge/shared/tracing.h"
 
 #include <QObject>
 #include <QThread>
@@ -32,6 +34,9 @@
  * up the model update.
  * A signal is sent after the update
  * has actually taken place.
+ * Updates via `writeAsync` don't even
+ * block the queue: many of them may be
+ * in flight at the same time.
 */
 class ModelUpdateQueue: public QObject
 {
@@ -75,6 +80,7 @@ public:
 	}
 
 	void printThreadId() {
+		FGE_TRACE_THREAD( "MODEL UPDATE QUEUE" );
 		qDebug() << "MODEL UPDATE THREAD:" << (unsigned long )QThread::currentThreadId();
 	}
 
@@ -94,6 +100,12 @@ public:
 		}, Qt::QueuedConnection );
 	}
 
+	// lock free, may be called from any thread
+	// (no need to wait for pending updates):
+	uint64_t getSilentBlockCount() const {
+		return model->getSilentBlockCount();
+	}
+
 	template <typename Function, typename Continuation>
 	void read(
 			QObject* continueCtxt,
@@ -104,7 +116,10 @@ public:
 			QMetaObject::invokeMethod(
 					this,
 					[this,continueCtxt,f,doneCallback](){
-						f(std::as_const(model));
+						{
+							FGE_TRACE_SCOPE( "queue", "read" );
+							f(std::as_const(model));
+						}
 						writeDone(
 								[this,doneCallback]{
 									doneCallback(std::as_const(model));
@@ -118,7 +133,10 @@ public:
 			QMetaObject::invokeMethod(
 					this,
 					[this,continueCtxt,f,doneCallback](){
-						auto ret = f(std::as_const(model));
+						auto ret = [&]{
+							FGE_TRACE_SCOPE( "queue", "read" );
+							return f(std::as_const(model));
+						}();
 						writeDone(
 								[this,doneCallback,ret]{
 									doneCallback(std::as_const(model), ret);
@@ -138,11 +156,17 @@ public:
 			Continuation doneCallback
 	) {
 		qDebug() << "ModelUpdateQueue::write" << updateName;
+#ifdef FGE_TRACING
+		const char* traceName = tracing::internString( updateName );
+#endif
 		if constexpr ( std::same_as<decltype(f(model)),void> ) {
 			QMetaObject::invokeMethod(
 					this,
-					[this,continueCtxt,f,doneCallback]{
-						f(model);
+					[=,this]{
+						{
+							FGE_TRACE_SCOPE( "queue", traceName );
+							f(model);
+						}
 						emit writeDone(
 								[this,doneCallback]{
 									doneCallback(std::as_const(model));
@@ -155,8 +179,11 @@ public:
 		else {
 			QMetaObject::invokeMethod(
 					this,
-					[this,continueCtxt,f,doneCallback]{
-						auto ret = f(model);
+					[=,this]{
+						auto ret = [&]{
+							FGE_TRACE_SCOPE( "queue", traceName );
+							return f(model);
+						}();
 						emit writeDone(
 								[this,doneCallback,ret]{
 									doneCallback(std::as_const(model), ret);
@@ -168,6 +195,40 @@ public:
 		}
 	}
 
+	/* `f(model, resolve)` starts a non
+	 * blocking update and returns.
+	 * `resolve(args...)` may be called
+	 * from any thread, once the update has
+	 * taken place. `doneCallback(model, args...)`
+	 * then runs in the gui thread:
+	 */
+	template <typename Function, typename Continuation>
+	void writeAsync(
+			QObject* continueCtxt,
+			const QString& updateName,
+			Function f,
+			Continuation doneCallback
+	) {
+		qDebug() << "ModelUpdateQueue::writeAsync" << updateName;
+#ifdef FGE_TRACING
+		const char* traceName = tracing::internString( updateName );
+#endif
+		QMetaObject::invokeMethod(
+				this,
+				[=,this]{
+					FGE_TRACE_SCOPE( "queue", traceName );
+					f(model, [this,doneCallback](auto... ret) {
+							emit writeDone(
+									[this,doneCallback,ret...]{
+										doneCallback(std::as_const(model), ret...);
+									}
+							);
+					});
+				},
+				Qt::QueuedConnection
+		);
+	}
+
 private:
 	Model* model;
 	QThread* workerThread;
@@ -207,12 +268,29 @@ private:
 	void startPlayback();
 	std::future<void> stopPlayback();
 
+	// spectrum analysis:
+	void setAnalyzer(
+			const uint iFunction,
+			const SpectrumSettings& settings
+	);
+	void updateAnalyzers();
+
 private:
+	/* analysis stage of one function,
+	 * runs in the gui thread:
+	 */
+	struct Analyzer {
+		std::shared_ptr<SampleTap> tap;
+		std::unique_ptr<STFT> stft;
+	};
+
 	Application* application;
 	MainWindow* view;
 	std::shared_ptr<JackClient> maybeJack;
 	const uint viewResolution;
 	ModelUpdateQueue* modelUpdateQueue;
+	std::map<uint,Analyzer> analyzers;
+	std::vector<float> analysisBuffer;
 
 };
 
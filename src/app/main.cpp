@@ -4,6 +4,7 @@
 #include "fge/view/mainwindow.h"
 #include "fge/audio/jack.h"
 #include "fge/shared/config.h"
+#include "fge/shared/lock_statistics.h"
 #include "application.h"
 
 #include <QApplication>
@@ -86,6 +87,9 @@ int main(int argc, char *argv[])
 
 	controller.exit();
 
+#ifdef FGE_MUTEX_STATS
+	qInfo().noquote() << "lock statistics:\n" + lock_statistics::report();
+#endif
 	qInfo().nospace() << "exit.";
 	return ret;
 }
@@ -1,4 +1,7 @@
 #include "fge/audio/audio_worker.h"
+#include "fge/shared/lock_statistics.h"
+#include "fge/shared/rt_safety.h"
+#include "fge/shared/tracing.h"
 #include <chrono>
 #include <climits>
 #include <cstddef>
@@ -32,8 +35,7 @@ void AudioWorker::resize(
 	qDebug() << "buffer size:" << size;
 	this->samplerate = samplerate;
 	this->ringBuffer.init( size );
-	using namespace std::chrono_literals;
-	statistics.deadline = 1000000us / samplerate * size;
+	deadline = int64_t(1000000000) * size / samplerate;
 }
 
 using namespace std::chrono_literals;
@@ -42,16 +44,21 @@ void AudioWorker::run() {
 	position = 0;
 	stopWorkerSignal = false;
 	isRunning = true;
-	using microsec = std::chrono::microseconds;
-	statistics.avg_time = 0s;
-	statistics.max_time = 0s;
+	blockTimes.write([](auto& times) {
+			times = {};
+	});
 	// repeatedly fill buffer:
 	worker = std::thread([this]{
+		FGE_TRACE_THREAD( "AUDIO WORKER" );
+		lock_statistics::isAudioThread() = true;
+		rt_safety::setRealtimeThread( true );
 		while(!stopWorkerSignal) {
 			const auto t0{std::chrono::steady_clock::now()};
 			// wait, until buffer not being full,
 			// then fill next window:
 			ringBuffer.write([this](auto buffer){
+				FGE_TRACE_SCOPE( "audio", "render block" );
+				FGE_RT_SCOPE( "render block" );
 				const auto t0{std::chrono::steady_clock::now()};
 				callbacks.valuesToBuffer(
 						buffer,
@@ -60,13 +67,22 @@ void AudioWorker::run() {
 				);
 				this->position += ringBuffer.getSize();
 				const auto t1{std::chrono::steady_clock::now()};
-				const auto diff = std::chrono::duration_cast<microsec>(t1 - t0);
-				statistics.avg_time = diff;
-				statistics.max_time = std::max( statistics.max_time, diff );
+				const std::chrono::nanoseconds diff = t1 - t0;
+				histogram.record( diff, std::chrono::nanoseconds(deadline.load(std::memory_order_relaxed)) );
+				blockTimes.write([diff](auto& times) {
+						times.totalTime += diff.count();
+						times.maxTime = std::max( times.maxTime, int64_t(diff.count()) );
+						times.blocks++;
+				});
 			});
 
-			callbacks.betweenAudioCallback(position, samplerate);
+			{
+				FGE_TRACE_SCOPE( "audio", "between blocks" );
+				FGE_RT_SCOPE( "between blocks" );
+				callbacks.betweenAudioCallback(position, samplerate);
+			}
 		}
+		rt_safety::setRealtimeThread( false );
 		qDebug().nospace() << "AUDIO THREAD done: ";
 		isRunning = false;
 	});
@@ -79,8 +95,9 @@ void AudioWorker::run() {
 void AudioWorker::stop() {
 	stopWorkerSignal = true;
 	worker.join();
-	statistics.avg_time = 0s;
-	statistics.max_time = 0s;
+	blockTimes.write([](auto& times) {
+			times = {};
+	});
 }
 
 bool AudioWorker::getIsRunning() const {
@@ -88,6 +105,33 @@ bool AudioWorker::getIsRunning() const {
 }
 
 
-const Statistics& AudioWorker::getStatistics() const {
-	return statistics;
+void AudioWorker::markUnderrun() {
+	lastUnderrun.store(
+			std::chrono::steady_clock::now().time_since_epoch().count(),
+			std::memory_order_relaxed
+	);
+}
+
+Statistics AudioWorker::getStatistics() const {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+	using std::chrono::nanoseconds;
+	Statistics ret;
+	const auto times = blockTimes.read();
+	ret.deadline = duration_cast<microseconds>( nanoseconds( deadline.load() ) );
+	ret.max_time = duration_cast<microseconds>( nanoseconds( times.maxTime ) );
+	if( times.blocks > 0 ) {
+		ret.avg_time = duration_cast<microseconds>( nanoseconds( times.totalTime / int64_t(times.blocks) ) );
+	}
+	ret.latency = histogram.percentiles();
+	ret.overruns = histogram.getOverruns();
+	ret.underruns = underruns.load( std::memory_order_relaxed );
+	const auto last = lastUnderrun.load( std::memory_order_relaxed );
+	if( last != 0 ) {
+		const auto now = std::chrono::steady_clock::now().time_since_epoch();
+		ret.sinceLastUnderrun = duration_cast<std::chrono::milliseconds>(
+				now - std::chrono::steady_clock::duration( last )
+		);
+	}
+	return ret;
 }
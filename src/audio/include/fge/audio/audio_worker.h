@@ -2,6 +2,8 @@
 #define AUDIO_WORKER_H
 
 #include "fge/audio/sample_ring_buffer.h"
+#include "fge/shared/concurrency_utils.h"
+#include "fge/shared/latency_histogram.h"
 #include "fge/shared/utils.h"
 #include <chrono>
 #include <jack/jack.h>
@@ -59,15 +61,23 @@ class AudioWorker
 				sample_t* buffer
 		)
 		{
-			ringBuffer.read([buffer, size=ringBuffer.getSize()](auto srcBuffer) {
+			const bool ready = ringBuffer.read([buffer, size=ringBuffer.getSize()](auto srcBuffer) {
 				memcpy(
 						buffer,
 						srcBuffer->data(),
 						sizeof(sample_t) * size
 				);
 			});
+			if( !ready ) {
+				underruns.fetch_add( 1, std::memory_order_relaxed );
+				markUnderrun();
+			}
 		}
 
+		// called from the jack thread
+		// on any kind of dropout:
+		void markUnderrun();
+
 		// Start worker thread
 		void run();
 		// Stop worker thread
@@ -75,7 +85,10 @@ class AudioWorker
 
 		// Is worker thread running?
 		bool getIsRunning() const;
-		const Statistics& getStatistics() const;
+		/* lock free, may be called
+		 * from any thread while running
+		 */
+		Statistics getStatistics() const;
 	private:
 		SampleRingBuffer ringBuffer;
 		std::thread worker;
@@ -86,7 +99,19 @@ class AudioWorker
 		PlaybackPosition position = 0;
 		uint samplerate = 0;
 
-		Statistics statistics;
+		// statistics:
+		struct BlockTimes {
+			int64_t maxTime = 0; // ns
+			int64_t totalTime = 0; // ns
+			uint64_t blocks = 0;
+		};
+		std::atomic<int64_t> deadline = 0; // ns
+		// written by the worker thread only:
+		seqlock_guarded<BlockTimes> blockTimes{ "BLOCK TIMES" };
+		LatencyHistogram histogram;
+		std::atomic<uint64_t> underruns = 0;
+		// steady clock, ns since epoch, 0: never
+		std::atomic<int64_t> lastUnderrun = 0;
 };
 
 #endif
@@ -28,7 +28,7 @@ class JackClient {
 
 		QString getClientName() const;
 		uint getSamplerate();
-		const Statistics& getStatistics() const;
+		Statistics getStatistics() const;
 
 		void setBufferSize(
 				const uint32_t size
@@ -38,6 +38,9 @@ class JackClient {
 			jack_nframes_t nframes,
 			void* arg
 	);
+	friend int xrunCallback(
+			void* arg
+	);
 
 	private:
 		// init/exit jack client:
@@ -52,6 +55,7 @@ class JackClient {
 		// jack:
 		jack_client_t* client = nullptr;
 		jack_port_t* ports[1] = { nullptr };
+		std::atomic<uint64_t> xruns = 0;
 
 #ifdef AUDIO_STUB
 		std::atomic<bool> isJackFakeThreadRunning;
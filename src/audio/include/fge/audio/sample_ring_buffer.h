@@ -26,13 +26,18 @@ class SampleRingBuffer
 		}
 		/// read from the buffer
 		/// blocks if empty
+		/// returns false, if it had to block
 		template <typename Function>
-		void read( Function f)
+		bool read( Function f)
 		{
-			hasData.acquire();
+			const bool ready = hasData.try_acquire();
+			if( !ready ) {
+				hasData.acquire();
+			}
 			f( &buffer[readIndex] );
 			readIndex = (readIndex + 1) % count;
 			notFull.release();
+			return ready;
 		}
 		/// write to the buffer
 		/// blocks if full
@@ -1,5 +1,7 @@
 #include "fge/audio/jack.h"
 #include "fge/shared/data.h"
+#include "fge/shared/rt_safety.h"
+#include "fge/shared/tracing.h"
 #include <chrono>
 #include <climits>
 #include <cstddef>
@@ -25,6 +27,14 @@ int setBufferSizeCallback(
 		void* arg
 );
 
+int xrunCallback(
+		void* arg
+);
+
+void threadInitCallback(
+		void* arg
+);
+
 /********************
  * JackClient
 *********************/
@@ -71,6 +81,16 @@ MaybeError JackClient::init() {
 				&setBufferSizeCallback,
 				this
 		);
+		jack_set_xrun_callback(
+				client,
+				&xrunCallback,
+				this
+		);
+		jack_set_thread_init_callback(
+				client,
+				&threadInitCallback,
+				this
+		);
 		// create ports:
 		{
 			auto flags = JackPortIsOutput;
@@ -180,9 +200,11 @@ uint JackClient::getSamplerate()
 	return samplerate;
 }
 
-const Statistics& JackClient::getStatistics() const
+Statistics JackClient::getStatistics() const
 {
-	return audioWorker.getStatistics();
+	auto ret = audioWorker.getStatistics();
+	ret.xruns = xruns.load( std::memory_order_relaxed );
+	return ret;
 }
 
 void JackClient::setBufferSize(
@@ -200,6 +222,8 @@ int processAudio(
 		jack_nframes_t nframes,
 		void* arg
 ) {
+	FGE_TRACE_SCOPE( "jack", "process" );
+	FGE_RT_SCOPE( "jack process" );
 	auto jackObj = (JackClient* )arg;
 	sample_t* buffer = (sample_t* )jack_port_get_buffer(
 			jackObj->ports[0],
@@ -225,3 +249,20 @@ int setBufferSizeCallback(
 	jackObj->setBufferSize( nframes );
 	return 0;
 }
+
+int xrunCallback(
+		void* arg
+)
+{
+	auto jackObj = (JackClient* )arg;
+	jackObj->xruns.fetch_add( 1, std::memory_order_relaxed );
+	jackObj->audioWorker.markUnderrun();
+	return 0;
+}
+
+void threadInitCallback(
+		void* arg
+)
+{
+	rt_safety::setRealtimeThread( true );
+}
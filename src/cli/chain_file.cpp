@@ -0,0 +1,143 @@
+#include "chain_file.h"
+#include "fge/shared/parameter_utils.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+
+namespace intern {
+
+	ErrorOrValue<ChainEntry> parseEntry(
+			const QJsonObject& object,
+			const uint index
+	);
+
+} // namespace intern
+
+ErrorOrValue<Chain> loadChainFile(
+		const QString& path
+)
+{
+	QFile file( path );
+	if( !file.open( QIODevice::ReadOnly ) ) {
+		return std::unexpected( QString("failed to open '%1': %2")
+				.arg( path )
+				.arg( file.errorString() )
+		);
+	}
+	return parseChain( file.readAll() );
+}
+
+ErrorOrValue<Chain> parseChain(
+		const QByteArray& json
+)
+{
+	QJsonParseError parseError;
+	const auto document = QJsonDocument::fromJson( json, &parseError );
+	if( document.isNull() ) {
+		return std::unexpected( QString("invalid json: %1")
+				.arg( parseError.errorString() )
+		);
+	}
+	if( !document.isObject() || !document.object().value("functions").isArray() ) {
+		return std::unexpected( Error("expected an object with a \"functions\" array") );
+	}
+	const auto functions = document.object().value("functions").toArray();
+	Chain ret;
+	for( qsizetype i=0; i<functions.size(); i++ ) {
+		if( !functions[i].isObject() ) {
+			return std::unexpected( QString("function %1: expected an object").arg(i) );
+		}
+		auto maybeEntry = intern::parseEntry( functions[i].toObject(), i );
+		if( !maybeEntry ) {
+			return std::unexpected( maybeEntry.error() );
+		}
+		ret.push_back( maybeEntry.value() );
+	}
+	return ret;
+}
+
+MaybeError applyChain(
+		Model* model,
+		const Chain& chain
+)
+{
+	model->resize( chain.size() );
+	for( uint index=0; index<chain.size(); index++ ) {
+		const auto& entry = chain[index];
+		const auto dataDescription = parseFunctionDataDescription( entry.dataDescription );
+		ParameterBindings parameters;
+		for( auto [name, descr] : dataDescription.parameterDescriptions ) {
+			parameters[name] = descr.initial;
+		}
+		for( auto [name, value] : entry.parameters ) {
+			if( !parameters.contains( name ) ) {
+				return QString("function %1: unknown parameter '%2'")
+					.arg( index )
+					.arg( name );
+			}
+			parameters[name] = value;
+		}
+		auto maybeError = model->bulkUpdate( index, Model::Update{
+				.formula = entry.formula,
+				.parameters = parameters,
+				.parameterDescriptions = dataDescription.parameterDescriptions,
+				.stateDescriptions = dataDescription.stateDescriptions,
+				.playbackSettings = entry.playbackSettings,
+				.playbackEnabled = entry.playbackEnabled,
+				.samplingSettings = entry.samplingSettings
+		});
+		if( maybeError ) {
+			return QString("function %1: %2")
+				.arg( index )
+				.arg( maybeError.value() );
+		}
+	}
+	return {};
+}
+
+namespace intern {
+
+ErrorOrValue<ChainEntry> parseEntry(
+		const QJsonObject& object,
+		const uint index
+)
+{
+	if( !object.value("formula").isString() ) {
+		return std::unexpected( QString("function %1: missing \"formula\"").arg(index) );
+	}
+	ChainEntry ret{
+		.formula = object.value("formula").toString(),
+		.dataDescription = object.value("data").toString(),
+		.parameters = {},
+		.playbackEnabled = object.value("playback").toBool( false ),
+		.playbackSettings = PlaybackSettings{
+			.playbackSpeed = object.value("playbackSpeed").toDouble( 1 )
+		},
+		.samplingSettings = {}
+	};
+	const auto parameters = object.value("parameters").toObject();
+	for( auto it = parameters.begin(); it != parameters.end(); it++ ) {
+		if( !it.value().isDouble() ) {
+			return std::unexpected( QString("function %1: parameter '%2' is not a number")
+					.arg( index )
+					.arg( it.key() )
+			);
+		}
+		ret.parameters[it.key()] = it.value().toDouble();
+	}
+	if( object.contains("sampling") ) {
+		const auto sampling = object.value("sampling").toObject();
+		const auto def = no_optimization_settings;
+		ret.samplingSettings = SamplingSettings{
+			.resolution = uint( sampling.value("resolution").toInt( def.resolution ) ),
+			.interpolation = uint( sampling.value("interpolation").toInt( def.interpolation ) ),
+			.periodic = sampling.value("periodic").toDouble( def.periodic ),
+			.buffered = sampling.value("buffered").toBool( def.buffered )
+		};
+	}
+	return ret;
+}
+
+} // namespace intern
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "fge/model/model.h"
+#include <vector>
+
+
+/**
+ * One function of a chain
+ * as stored in a chain file.
+ */
+struct ChainEntry {
+	QString formula;
+	// in the format of `parseFunctionDataDescription`:
+	QString dataDescription;
+	// overwrite initial parameter values:
+	ParameterBindings parameters;
+	bool playbackEnabled = false;
+	PlaybackSettings playbackSettings;
+	std::optional<SamplingSettings> samplingSettings;
+};
+
+using Chain = std::vector<ChainEntry>;
+
+/**
+ * Chain file format (JSON):
+ *
+ * {
+ *   "functions": [
+ *     {
+ *       "formula": "sin(2*pi*freq*x)",
+ *       "data": "parameter 1 freq 440 20 20000",
+ *       "parameters": { "freq": 220 },
+ *       "playback": true,
+ *       "playbackSpeed": 1,
+ *       "sampling": {
+ *         "resolution": 44100,
+ *         "interpolation": 1,
+ *         "periodic": 0,
+ *         "buffered": false
+ *       }
+ *     }
+ *   ]
+ * }
+ *
+ * All fields except "formula" are optional.
+ */
+ErrorOrValue<Chain> loadChainFile(
+		const QString& path
+);
+
+ErrorOrValue<Chain> parseChain(
+		const QByteArray& json
+);
+
+/**
+ * Resize the model and set every entry
+ * of the chain.
+ * Stops at the first invalid function.
+ */
+MaybeError applyChain(
+		Model* model,
+		const Chain& chain
+);
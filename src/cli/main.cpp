@@ -0,0 +1,314 @@
+#include "chain_file.h"
+#include "fge/model/model.h"
+#include "fge/render/offline_renderer.h"
+#include "fge/shared/config.h"
+#include "fge/shared/lock_statistics.h"
+#include "fge/shared/tracing.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+
+/**
+ * Headless batch evaluator.
+ * Loads a chain of functions from
+ * a chain file (see `chain_file.h`) and
+ * either samples one function
+ * or renders the audio output.
+ * Links neither QtWidgets nor JACK.
+ */
+
+struct EvalSettings {
+	Index function;
+	std::pair<T,T> range;
+	uint resolution;
+	bool binary;
+};
+
+MaybeError eval(
+		const Model* model,
+		const EvalSettings& settings,
+		QFile* output
+);
+
+MaybeError render(
+		Model* model,
+		const RenderSettings& settings,
+		const SampleFormat sampleFormat,
+		const QString& outputPath
+);
+
+template <typename Value>
+ErrorOrValue<Value> parseNumber(
+		const QCommandLineParser& parser,
+		const QString& option
+);
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName( "fge-cli" );
+	QCoreApplication::setApplicationVersion( PROJECT_VERSION );
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(
+			"Evaluate function chains without GUI.\n"
+			"\n"
+			"eval:   sample one function of the chain over a range.\n"
+			"        text output: one line \"x re im\" per sample.\n"
+			"        binary output: interleaved (re,im) pairs of native 64 bit doubles.\n"
+			"render: render the audio output of the chain.\n"
+			"        output \"-\" streams raw native 32 bit floats (mono)."
+	);
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument( "command", "eval | render" );
+	parser.addPositionalArgument( "chain", "chain file (JSON)" );
+	parser.addOptions({
+			{ {"o", "output"}, "output file, \"-\" for stdout (default).", "file", "-" },
+			{ "trace", "write a chrome trace (JSON) to file. Requires a build with FGE_TRACING.", "file" },
+			{ "lock-stats", "print lock contention statistics to stderr. Requires a build with FGE_MUTEX_STATS." },
+			// eval:
+			{ {"f", "function"}, "eval: index of the function (default: last).", "index" },
+			{ "from", "eval: start of the range.", "x", "0" },
+			{ "to", "eval: end of the range.", "x", "1" },
+			{ {"r", "resolution"}, "eval: number of samples.", "n", "1000" },
+			{ {"b", "binary"}, "eval: write binary instead of text." },
+			// render:
+			{ {"d", "duration"}, "render: duration in seconds.", "seconds", "1" },
+			{ {"s", "samplerate"}, "render: samplerate.", "hz", "44100" },
+			{ "block-size", "render: samples per block.", "n", "1024" },
+			{ "sample-format", "render: int16 | int24 | float32.", "format", "int16" },
+	});
+	parser.process( app );
+
+	const auto args = parser.positionalArguments();
+	if( args.size() != 2 ) {
+		parser.showHelp( 1 );
+	}
+	const auto command = args[0];
+	if( command != "eval" && command != "render" ) {
+		qCritical().noquote() << "unknown command:" << command;
+		return 1;
+	}
+
+	auto maybeChain = loadChainFile( args[1] );
+	if( !maybeChain ) {
+		qCritical().noquote() << maybeChain.error();
+		return 1;
+	}
+	const auto chain = maybeChain.value();
+	if( chain.size() == 0 ) {
+		qCritical().noquote() << "empty chain";
+		return 1;
+	}
+
+	auto model = modelFactory();
+	if( auto maybeError = applyChain( model.get(), chain ) ) {
+		qCritical().noquote() << maybeError.value();
+		return 1;
+	}
+
+	const auto outputPath = parser.value( "output" );
+	MaybeError maybeError = {};
+	if( command == "eval" ) {
+		auto function = parser.isSet( "function" )
+			? parseNumber<uint>( parser, "function" )
+			: ErrorOrValue<uint>( chain.size()-1 );
+		auto from = parseNumber<T>( parser, "from" );
+		auto to = parseNumber<T>( parser, "to" );
+		auto resolution = parseNumber<uint>( parser, "resolution" );
+		for( auto error : { function.error_or(""), from.error_or(""), to.error_or(""), resolution.error_or("") } ) {
+			if( error != "" ) {
+				qCritical().noquote() << error;
+				return 1;
+			}
+		}
+		if( function.value() >= chain.size() ) {
+			qCritical().noquote() << "function index out of range";
+			return 1;
+		}
+		QFile output;
+		bool opened = false;
+		if( outputPath == "-" ) {
+			opened = output.open( stdout, QIODevice::WriteOnly );
+		}
+		else {
+			output.setFileName( outputPath );
+			opened = output.open( QIODevice::WriteOnly | QIODevice::Truncate );
+		}
+		if( !opened ) {
+			qCritical().noquote() << "failed to open output:" << output.errorString();
+			return 1;
+		}
+		maybeError = eval(
+				model.get(),
+				EvalSettings{
+					.function = function.value(),
+					.range = { from.value(), to.value() },
+					.resolution = resolution.value(),
+					.binary = parser.isSet( "binary" )
+				},
+				&output
+		);
+	}
+	else {
+		auto duration = parseNumber<double>( parser, "duration" );
+		auto samplerate = parseNumber<uint>( parser, "samplerate" );
+		auto blockSize = parseNumber<uint>( parser, "block-size" );
+		for( auto error : { duration.error_or(""), samplerate.error_or(""), blockSize.error_or("") } ) {
+			if( error != "" ) {
+				qCritical().noquote() << error;
+				return 1;
+			}
+		}
+		const auto sampleFormatStr = parser.value( "sample-format" );
+		SampleFormat sampleFormat = SampleFormat::Int16;
+		if( sampleFormatStr == "int24" ) {
+			sampleFormat = SampleFormat::Int24;
+		}
+		else if( sampleFormatStr == "float32" ) {
+			sampleFormat = SampleFormat::Float32;
+		}
+		else if( sampleFormatStr != "int16" ) {
+			qCritical().noquote() << "invalid sample format:" << sampleFormatStr;
+			return 1;
+		}
+		maybeError = render(
+				model.get(),
+				RenderSettings{
+					.samplerate = samplerate.value(),
+					.duration = duration.value(),
+					.blockSize = blockSize.value()
+				},
+				sampleFormat,
+				outputPath
+		);
+	}
+	if( maybeError ) {
+		qCritical().noquote() << maybeError.value();
+		return 1;
+	}
+	if( parser.isSet( "lock-stats" ) ) {
+#ifdef FGE_MUTEX_STATS
+		QTextStream( stderr ) << lock_statistics::report();
+#else
+		qWarning().noquote() << "lock statistics are disabled, rebuild with -DFGE_MUTEX_STATS=ON";
+#endif
+	}
+	if( parser.isSet( "trace" ) ) {
+		if( auto maybeTraceError = tracing::writeChromeTrace( parser.value( "trace" ) ) ) {
+			qCritical().noquote() << maybeTraceError.value();
+			return 1;
+		}
+	}
+	return 0;
+}
+
+MaybeError eval(
+		const Model* model,
+		const EvalSettings& settings,
+		QFile* output
+)
+{
+	auto maybeGraph = model->getGraph(
+			settings.function,
+			settings.range,
+			settings.resolution
+	);
+	if( !maybeGraph ) {
+		return maybeGraph.error();
+	}
+	const auto& graph = maybeGraph.value();
+	if( settings.binary ) {
+		std::vector<double> buffer;
+		buffer.reserve( graph.size() * 2 );
+		for( auto [x,y] : graph ) {
+			buffer.push_back( y.c_.real() );
+			buffer.push_back( y.c_.imag() );
+		}
+		const auto size = qint64( buffer.size() * sizeof(double) );
+		if( output->write( reinterpret_cast<const char*>(buffer.data()), size ) != size ) {
+			return "failed to write output";
+		}
+	}
+	else {
+		QTextStream stream( output );
+		stream.setRealNumberPrecision( 17 );
+		for( auto [x,y] : graph ) {
+			stream << x.c_.real() << " " << y.c_.real() << " " << y.c_.imag() << "\n";
+		}
+		stream.flush();
+		if( stream.status() != QTextStream::Ok ) {
+			return "failed to write output";
+		}
+	}
+	return {};
+}
+
+MaybeError render(
+		Model* model,
+		const RenderSettings& settings,
+		const SampleFormat sampleFormat,
+		const QString& outputPath
+)
+{
+	OfflineRenderer renderer( model, settings );
+	ErrorOrValue<RenderStatistics> maybeStatistics;
+	if( outputPath == "-" ) {
+		maybeStatistics = renderer.render( [](const auto& block) -> MaybeError {
+				if( std::fwrite( block.data(), sizeof(float), block.size(), stdout ) != block.size() ) {
+					return "failed to write output";
+				}
+				return {};
+		});
+		std::fflush( stdout );
+	}
+	else {
+		const auto format = audioFileFormatFromPath( outputPath );
+		if( !isAudioFileFormatSupported( format ) ) {
+			return "audio file format not supported by this build";
+		}
+		maybeStatistics = renderer.render(
+				outputPath,
+				AudioFileSettings{
+					.format = format,
+					.sampleFormat = sampleFormat,
+					.samplerate = settings.samplerate
+				}
+		);
+	}
+	if( !maybeStatistics ) {
+		return maybeStatistics.error();
+	}
+	qInfo().nospace()
+		<< "rendered " << maybeStatistics->samplesRendered << " samples in "
+		<< maybeStatistics->renderTime.count() / 1000.0 << "ms "
+		<< "(" << maybeStatistics->realtimeFactor( settings.samplerate ) << "x realtime)";
+	return {};
+}
+
+template <typename Value>
+ErrorOrValue<Value> parseNumber(
+		const QCommandLineParser& parser,
+		const QString& option
+)
+{
+	bool ok = false;
+	const auto str = parser.value( option );
+	Value ret;
+	if constexpr( std::is_floating_point_v<Value> ) {
+		ret = str.toDouble( &ok );
+	}
+	else {
+		ret = str.toUInt( &ok );
+	}
+	if( !ok ) {
+		return std::unexpected( QString("invalid value for --%1: '%2'").arg( option ).arg( str ) );
+	}
+	return ret;
+}
@@ -0,0 +1,205 @@
+#include "fge/model/convolution.h"
+#include <algorithm>
+
+
+/*******************
+ * PartitionedConvolution
+ ******************/
+
+PartitionedConvolution::PartitionedConvolution(
+		const size_t blockSize
+)
+	: blockSize( blockSize )
+	, plan( 2*blockSize )
+	, inputBuffer( 2*blockSize, value_t(0) )
+	, outputBlock( blockSize, value_t(0) )
+	, accumulator( 2*blockSize, value_t(0) )
+{}
+
+void PartitionedConvolution::setKernel( const C* kernel, const size_t size )
+{
+	this->kernel.resize( size );
+	for( size_t i=0; i<size; i++ ) {
+		this->kernel[i] = kernel[i].c_;
+	}
+	const size_t partitions = (size + blockSize - 1) / blockSize;
+	if( partitions != kernelSpectra.size() ) {
+		kernelSpectra.assign( partitions, std::vector<value_t>( 2*blockSize ) );
+		inputSpectra.assign( partitions, std::vector<value_t>( 2*blockSize, value_t(0) ) );
+		fdlPos = 0;
+	}
+	for( size_t p=0; p<partitions; p++ ) {
+		auto& spectrum = kernelSpectra[p];
+		std::ranges::fill( spectrum, value_t(0) );
+		const size_t count = std::min( blockSize, size - p*blockSize );
+		std::copy_n( this->kernel.begin() + p*blockSize, count, spectrum.begin() );
+		plan.forward( spectrum.data() );
+	}
+}
+
+bool PartitionedConvolution::kernelEquals( const C* kernel, const size_t size ) const
+{
+	if( size != this->kernel.size() ) {
+		return false;
+	}
+	for( size_t i=0; i<size; i++ ) {
+		if( kernel[i].c_ != this->kernel[i] ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+C PartitionedConvolution::process( const C& input )
+{
+	const auto ret = outputBlock[pos];
+	inputBuffer[blockSize + pos] = input.c_;
+	pos++;
+	if( pos == blockSize ) {
+		processBlock();
+		pos = 0;
+	}
+	return C( ret );
+}
+
+void PartitionedConvolution::reset()
+{
+	for( auto& spectrum : inputSpectra ) {
+		std::ranges::fill( spectrum, value_t(0) );
+	}
+	std::ranges::fill( inputBuffer, value_t(0) );
+	std::ranges::fill( outputBlock, value_t(0) );
+	fdlPos = 0;
+	pos = 0;
+}
+
+void PartitionedConvolution::processBlock()
+{
+	const size_t partitions = kernelSpectra.size();
+	if( partitions == 0 ) {
+		std::ranges::fill( outputBlock, value_t(0) );
+	}
+	else {
+		// spectrum of [previous block, current block]:
+		auto& current = inputSpectra[fdlPos];
+		std::ranges::copy( inputBuffer, current.begin() );
+		plan.forward( current.data() );
+		// sum over partitions, the input
+		// spectrum of p blocks ago is
+		// multiplied with partition p:
+		std::ranges::fill( accumulator, value_t(0) );
+		for( size_t p=0; p<partitions; p++ ) {
+			const auto& in = inputSpectra[(fdlPos + partitions - p) % partitions];
+			const auto& h = kernelSpectra[p];
+			for( size_t k=0; k<2*blockSize; k++ ) {
+				accumulator[k] += in[k] * h[k];
+			}
+		}
+		plan.inverse( accumulator.data() );
+		// overlap-save: only the 2nd half is valid:
+		std::copy_n( accumulator.begin() + blockSize, blockSize, outputBlock.begin() );
+		fdlPos = (fdlPos + 1) % partitions;
+	}
+	std::copy_n( inputBuffer.begin() + blockSize, blockSize, inputBuffer.begin() );
+}
+
+/*******************
+ * ConvolveFunction
+ ******************/
+
+ConvolveFunction::ConvolveFunction()
+	: exprtk::igeneric_function<C>("TV")
+{}
+
+void ConvolveFunction::prepare( const C* kernel, const size_t size )
+{
+	auto it = std::ranges::find_if( instances, [kernel](const auto& entry) {
+			return entry.first == kernel;
+	});
+	if( it == instances.end() ) {
+		instances.push_back({ kernel, std::make_unique<PartitionedConvolution>() });
+		it = instances.end() - 1;
+	}
+	it->second->setKernel( kernel, size );
+}
+
+C ConvolveFunction::operator()(parameter_list_t parameters)
+{
+	using generic_type = exprtk::igeneric_function<C>::generic_type;
+	using scalar_t = generic_type::scalar_view;
+	using vector_t = generic_type::vector_view;
+	scalar_t input(parameters[0]);
+	vector_t kernel(parameters[1]);
+	const C* key = kernel.begin();
+	auto it = std::ranges::find_if( instances, [key](const auto& entry) {
+			return entry.first == key;
+	});
+	if( it == instances.end() ) {
+		// not prepared, allocating
+		// is no option here:
+		return C(0,0);
+	}
+	auto& convolution = *it->second;
+	// the kernel is a state vector and
+	// may be written by the formula.
+	// check for changes once per block
+	// (same size, spectra are reused):
+	if(
+			convolution.atBlockStart()
+			&& !convolution.kernelEquals( kernel.begin(), kernel.size() )
+	) {
+		convolution.setKernel( kernel.begin(), kernel.size() );
+	}
+	return convolution.process( input() );
+}
+
+void ConvolveFunction::reset()
+{
+	for( auto& [key, convolution] : instances ) {
+		convolution->reset();
+	}
+}
+
+std::vector<QString> convolveKernelNames( const QString& formula )
+{
+	const QString call = "convolve";
+	std::vector<QString> ret;
+	for(
+			auto pos = formula.indexOf( call );
+			pos != -1;
+			pos = formula.indexOf( call, pos + call.size() )
+	) {
+		if( pos > 0 && (formula[pos-1].isLetterOrNumber() || formula[pos-1] == '_') ) {
+			continue;
+		}
+		auto i = pos + call.size();
+		while( i < formula.size() && formula[i].isSpace() ) {
+			i++;
+		}
+		if( i >= formula.size() || formula[i] != '(' ) {
+			continue;
+		}
+		// the last argument on the top level:
+		int depth = 0;
+		qsizetype argStart = -1;
+		for( i++; i < formula.size(); i++ ) {
+			const auto c = formula[i];
+			if( c == '(' || c == '[' || c == '{' ) {
+				depth++;
+			}
+			else if( c == ')' || c == ']' || c == '}' ) {
+				if( depth == 0 ) {
+					if( argStart != -1 ) {
+						ret.push_back( formula.mid( argStart, i - argStart ).trimmed() );
+					}
+					break;
+				}
+				depth--;
+			}
+			else if( c == ',' && depth == 0 ) {
+				argStart = i + 1;
+			}
+		}
+	}
+	return ret;
+}
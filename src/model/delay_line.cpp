@@ -0,0 +1,84 @@
+#include "fge/model/delay_line.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+
+using generic_type = exprtk::igeneric_function<C>::generic_type;
+using scalar_t = generic_type::scalar_view;
+using vector_t = generic_type::vector_view;
+
+namespace intern {
+
+	// number of samples, 0 if too small:
+	inline size_t capacity( const vector_t& line )
+	{
+		if( line.size() <= delay_line::headerSize + 1 ) {
+			return 0;
+		}
+		return std::bit_floor( line.size() - delay_line::headerSize );
+	}
+
+	inline size_t writePosition( const vector_t& line, const size_t capacity )
+	{
+		return size_t( line[0].c_.real() ) & (capacity - 1);
+	}
+
+} // namespace intern
+
+size_t delay_line::stateSize( const size_t size )
+{
+	return headerSize + std::bit_ceil( std::max( size, size_t(2) ) );
+}
+
+/*******************
+ * DelayWriteFunction
+ ******************/
+
+DelayWriteFunction::DelayWriteFunction()
+	: exprtk::igeneric_function<C>("TV")
+{}
+
+C DelayWriteFunction::operator()(parameter_list_t parameters)
+{
+	scalar_t value(parameters[0]);
+	vector_t line(parameters[1]);
+	const size_t capacity = intern::capacity( line );
+	if( capacity == 0 ) {
+		return value();
+	}
+	const size_t pos = intern::writePosition( line, capacity );
+	line[delay_line::headerSize + pos] = value();
+	line[0] = C( T( (pos + 1) & (capacity - 1) ), 0 );
+	return value();
+}
+
+/*******************
+ * DelayReadFunction
+ ******************/
+
+DelayReadFunction::DelayReadFunction()
+	: exprtk::igeneric_function<C>("TV")
+{}
+
+C DelayReadFunction::operator()(parameter_list_t parameters)
+{
+	scalar_t samples(parameters[0]);
+	vector_t line(parameters[1]);
+	const size_t capacity = intern::capacity( line );
+	if( capacity == 0 ) {
+		return C(0,0);
+	}
+	const size_t mask = capacity - 1;
+	const size_t pos = intern::writePosition( line, capacity );
+	// the current sample isn't written yet,
+	// the oldest one is `capacity` writes ago:
+	const T delay = std::clamp( samples().c_.real(), T(1), T(capacity) );
+	// interpolate towards the oldest sample
+	// instead of reading past it:
+	const size_t whole = std::min( size_t( delay ), capacity - 1 );
+	const T fraction = delay - T(whole);
+	const auto& newer = line[delay_line::headerSize + ((pos - whole) & mask)].c_;
+	const auto& older = line[delay_line::headerSize + ((pos - whole - 1) & mask)].c_;
+	return C( newer + fraction * (older - newer) );
+}
@@ -0,0 +1,362 @@
+#include "fge/model/fft.h"
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <numbers>
+#include <unordered_map>
+
+
+namespace intern {
+
+	size_t log2( const size_t size ) {
+		return std::countr_zero( size );
+	}
+
+	void transform(
+			C* out, const size_t outSize,
+			const C* in, const size_t inSize,
+			const bool inverse
+	);
+
+	bool isIdentifierChar( const QChar c ) {
+		return c.isLetterOrNumber() || c == '_';
+	}
+
+	qsizetype skipSpaces( const QString& formula, qsizetype i ) {
+		while( i < formula.size() && formula[i].isSpace() ) {
+			i++;
+		}
+		return i;
+	}
+
+	/* positions after `word`,
+	 * if not part of a longer identifier:
+	 */
+	std::vector<qsizetype> findWord( const QString& formula, const QString& word ) {
+		std::vector<qsizetype> ret;
+		for(
+				auto pos = formula.indexOf( word );
+				pos != -1;
+				pos = formula.indexOf( word, pos + word.size() )
+		) {
+			const auto end = pos + word.size();
+			if(
+					(pos > 0 && isIdentifierChar( formula[pos-1] ))
+					|| (end < formula.size() && isIdentifierChar( formula[end] ))
+			) {
+				continue;
+			}
+			ret.push_back( end );
+		}
+		return ret;
+	}
+
+} // namespace intern
+
+/*******************
+ * FFTPlan
+ ******************/
+
+FFTPlan::FFTPlan( const size_t size )
+	: n( size )
+	, isPow2( std::has_single_bit( size ) )
+{
+	if( n <= 1 ) {
+		return;
+	}
+	if( isPow2 ) {
+		const auto bits = intern::log2( n );
+		bitReversed.resize( n );
+		for( size_t i=0; i<n; i++ ) {
+			size_t rev = 0;
+			for( size_t b=0; b<bits; b++ ) {
+				rev |= ((i >> b) & 1) << (bits - 1 - b);
+			}
+			bitReversed[i] = rev;
+		}
+		twiddles.resize( n/2 );
+		for( size_t k=0; k<n/2; k++ ) {
+			twiddles[k] = std::polar( T(1), -2 * std::numbers::pi * T(k) / T(n) );
+		}
+		return;
+	}
+	// bluestein:
+	//   X[k] = conj(w[k]) * sum_j (x[j] conj(w[j])) w[k-j]
+	//   w[j] = exp(i pi j^2/N)
+	const size_t m = std::bit_ceil( 2*n - 1 );
+	inner = std::make_unique<FFTPlan>( m );
+	chirp.resize( n );
+	for( size_t j=0; j<n; j++ ) {
+		// j^2 mod 2N keeps the angle accurate for big j:
+		const auto jj = (j * j) % (2 * n);
+		chirp[j] = std::polar( T(1), std::numbers::pi * T(jj) / T(n) );
+	}
+	chirpSpectrum.assign( m, value_t(0) );
+	chirpSpectrum[0] = chirp[0];
+	for( size_t j=1; j<n; j++ ) {
+		chirpSpectrum[j] = chirp[j];
+		chirpSpectrum[m-j] = chirp[j];
+	}
+	inner->forward( chirpSpectrum.data() );
+	scratch.resize( m );
+}
+
+void FFTPlan::forward( value_t* data )
+{
+	if( n <= 1 ) {
+		return;
+	}
+	if( isPow2 ) {
+		radix2( data );
+	}
+	else {
+		bluestein( data );
+	}
+}
+
+void FFTPlan::inverse( value_t* data )
+{
+	// ifft(x) = conj(fft(conj(x))) / N
+	for( size_t i=0; i<n; i++ ) {
+		data[i] = std::conj( data[i] );
+	}
+	forward( data );
+	const T scale = T(1) / T(n);
+	for( size_t i=0; i<n; i++ ) {
+		data[i] = std::conj( data[i] ) * scale;
+	}
+}
+
+void FFTPlan::radix2( value_t* data ) const
+{
+	for( size_t i=0; i<n; i++ ) {
+		const auto j = bitReversed[i];
+		if( i < j ) {
+			std::swap( data[i], data[j] );
+		}
+	}
+	// first stage without multiplications:
+	for( size_t k=0; k<n; k+=2 ) {
+		const auto lower = data[k];
+		const auto upper = data[k+1];
+		data[k] = lower + upper;
+		data[k+1] = lower - upper;
+	}
+	for( size_t m=4; m<=n; m*=2 ) {
+		const size_t half = m/2;
+		const size_t stride = n/m;
+		for( size_t k=0; k<n; k+=m ) {
+			value_t* a = data + k;
+			value_t* b = data + k + half;
+			for( size_t j=0; j<half; j++ ) {
+				const auto upper = twiddles[j*stride] * b[j];
+				b[j] = a[j] - upper;
+				a[j] += upper;
+			}
+		}
+	}
+}
+
+void FFTPlan::bluestein( value_t* data )
+{
+	const size_t m = inner->size();
+	for( size_t j=0; j<n; j++ ) {
+		scratch[j] = data[j] * std::conj( chirp[j] );
+	}
+	std::fill( scratch.begin() + n, scratch.end(), value_t(0) );
+	inner->forward( scratch.data() );
+	for( size_t k=0; k<m; k++ ) {
+		scratch[k] *= chirpSpectrum[k];
+	}
+	inner->inverse( scratch.data() );
+	for( size_t k=0; k<n; k++ ) {
+		data[k] = scratch[k] * std::conj( chirp[k] );
+	}
+}
+
+/*******************
+ * Utils
+ ******************/
+
+FFTPlan& fftPlan( const size_t size )
+{
+	thread_local std::unordered_map<size_t,std::unique_ptr<FFTPlan>> plans;
+	auto& plan = plans[size];
+	if( !plan ) {
+		plan = std::make_unique<FFTPlan>( size );
+	}
+	return *plan;
+}
+
+void fft(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize
+)
+{
+	intern::transform( out, outSize, in, inSize, false );
+}
+
+void ifft(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize
+)
+{
+	intern::transform( out, outSize, in, inSize, true );
+}
+
+/*******************
+ * FFTPlans
+ ******************/
+
+void FFTPlans::prepare( const size_t size )
+{
+	entry( size );
+}
+
+void FFTPlans::transform(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize,
+		const bool inverse
+)
+{
+	auto& [plan, work] = entry( outSize );
+	const auto count = std::min( inSize, outSize );
+	for( size_t i=0; i<count; i++ ) {
+		work[i] = in[i].c_;
+	}
+	std::fill( work.begin() + count, work.end(), FFTPlan::value_t(0) );
+	if( inverse ) {
+		plan->inverse( work.data() );
+	}
+	else {
+		plan->forward( work.data() );
+	}
+	for( size_t i=0; i<outSize; i++ ) {
+		out[i] = C( work[i] );
+	}
+}
+
+FFTPlans::Entry& FFTPlans::entry( const size_t size )
+{
+	auto it = std::ranges::find_if( entries, [size](const auto& entry) {
+			return entry.plan->size() == size;
+	});
+	if( it == entries.end() ) {
+		entries.push_back({
+				.plan = std::make_unique<FFTPlan>( size ),
+				.work = std::vector<FFTPlan::value_t>( size )
+		});
+		it = entries.end() - 1;
+	}
+	return *it;
+}
+
+/*******************
+ * FFTFunction
+ ******************/
+
+FFTFunction::FFTFunction( FFTPlans* plans, const bool inverse )
+	: exprtk::igeneric_function<C>("VV")
+	, plans( plans )
+	, inverse( inverse )
+{}
+
+C FFTFunction::operator()(parameter_list_t parameters)
+{
+	using generic_type = exprtk::igeneric_function<C>::generic_type;
+	using vector_t = generic_type::vector_view;
+	vector_t out(parameters[0]);
+	vector_t in(parameters[1]);
+	plans->transform( out.begin(), out.size(), in.begin(), in.size(), inverse );
+	return C(0,0);
+}
+
+std::vector<QString> fftOutputNames( const QString& formula )
+{
+	std::vector<QString> ret;
+	for( const QString call : { "fft", "ifft" } ) {
+		for( auto i : intern::findWord( formula, call ) ) {
+			i = intern::skipSpaces( formula, i );
+			if( i >= formula.size() || formula[i] != '(' ) {
+				continue;
+			}
+			// the first argument:
+			const auto argStart = i + 1;
+			int depth = 0;
+			for( i++; i < formula.size(); i++ ) {
+				const auto c = formula[i];
+				if( c == '(' || c == '[' || c == '{' ) {
+					depth++;
+				}
+				else if( (c == ')' || c == ']' || c == '}') && depth > 0 ) {
+					depth--;
+				}
+				else if( (c == ',' || c == ')') && depth == 0 ) {
+					ret.push_back( formula.mid( argStart, i - argStart ).trimmed() );
+					break;
+				}
+			}
+		}
+	}
+	return ret;
+}
+
+std::optional<size_t> localVectorSize(
+		const QString& formula,
+		const QString& name
+)
+{
+	for( auto i : intern::findWord( formula, "var" ) ) {
+		i = intern::skipSpaces( formula, i );
+		if( formula.mid( i, name.size() ) != name ) {
+			continue;
+		}
+		i += name.size();
+		if( i < formula.size() && intern::isIdentifierChar( formula[i] ) ) {
+			continue;
+		}
+		i = intern::skipSpaces( formula, i );
+		if( i >= formula.size() || formula[i] != '[' ) {
+			continue;
+		}
+		const auto end = formula.indexOf( ']', i );
+		if( end == -1 ) {
+			continue;
+		}
+		bool ok = false;
+		const auto size = formula.mid( i + 1, end - i - 1 ).trimmed().toUInt( &ok );
+		if( ok ) {
+			return size;
+		}
+	}
+	return {};
+}
+
+namespace intern {
+
+void transform(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize,
+		const bool inverse
+)
+{
+	thread_local std::vector<FFTPlan::value_t> work;
+	work.resize( outSize );
+	const auto count = std::min( inSize, outSize );
+	for( size_t i=0; i<count; i++ ) {
+		work[i] = in[i].c_;
+	}
+	std::fill( work.begin() + count, work.end(), FFTPlan::value_t(0) );
+	auto& plan = fftPlan( outSize );
+	if( inverse ) {
+		plan.inverse( work.data() );
+	}
+	else {
+		plan.forward( work.data() );
+	}
+	for( size_t i=0; i<outSize; i++ ) {
+		out[i] = C( work[i] );
+	}
+}
+
+} // namespace intern
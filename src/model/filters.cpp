@@ -0,0 +1,161 @@
+#include "fge/model/filters.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+
+using generic_type = exprtk::igeneric_function<C>::generic_type;
+using scalar_t = generic_type::scalar_view;
+using vector_t = generic_type::vector_view;
+
+namespace intern {
+
+	// approach `target`, jump on the first call:
+	inline T smooth( T* value, const T target, const bool initialized )
+	{
+		if( !initialized ) {
+			*value = target;
+		}
+		else {
+			*value += filters::smoothing * (target - *value);
+		}
+		return *value;
+	}
+
+	// initialized before this call:
+	inline bool initialize( vector_t& state )
+	{
+		const bool ret = state[0].c_.real() != 0;
+		state[0] = C(1,0);
+		return ret;
+	}
+
+	inline T real( vector_t& state, const size_t index )
+	{
+		return state[index].c_.real();
+	}
+
+	// clamp to (0,0.5) for stability:
+	inline T normalizedFrequency( const T value )
+	{
+		return std::clamp( value, T(1e-6), T(0.499) );
+	}
+
+} // namespace intern
+
+/*******************
+ * OnePoleFunction
+ ******************/
+
+OnePoleFunction::OnePoleFunction()
+	: exprtk::igeneric_function<C>("TTV")
+{}
+
+C OnePoleFunction::operator()(parameter_list_t parameters)
+{
+	scalar_t input(parameters[0]);
+	scalar_t cutoff(parameters[1]);
+	vector_t state(parameters[2]);
+	if( state.size() < filters::onePoleStateSize ) {
+		return input();
+	}
+	const bool initialized = intern::initialize( state );
+	T a = intern::real( state, 2 );
+	// impulse invariant:
+	intern::smooth(
+			&a,
+			1 - std::exp( -2 * std::numbers::pi * intern::normalizedFrequency( cutoff().c_.real() ) ),
+			initialized
+	);
+	state[2] = C(a,0);
+	const auto y = state[1].c_ + a * (input().c_ - state[1].c_);
+	state[1] = C(y);
+	return C(y);
+}
+
+/*******************
+ * BiquadFunction
+ ******************/
+
+BiquadFunction::BiquadFunction()
+	: exprtk::igeneric_function<C>("TVV")
+{}
+
+C BiquadFunction::operator()(parameter_list_t parameters)
+{
+	using filters::biquadCoeffs;
+	using filters::biquadSectionStateSize;
+	scalar_t input(parameters[0]);
+	vector_t coeffs(parameters[1]);
+	vector_t state(parameters[2]);
+	const size_t sections = coeffs.size() / biquadCoeffs;
+	if(
+			sections == 0
+			|| state.size() < filters::headerSize + sections * biquadSectionStateSize
+	) {
+		return input();
+	}
+	const bool initialized = intern::initialize( state );
+	auto value = input().c_;
+	for( size_t section=0; section<sections; section++ ) {
+		// z1, z2, b0, b1, b2, a1, a2:
+		const size_t offset = filters::headerSize + section * biquadSectionStateSize;
+		T c[biquadCoeffs];
+		for( size_t i=0; i<biquadCoeffs; i++ ) {
+			c[i] = intern::real( state, offset + 2 + i );
+			intern::smooth( &c[i], coeffs[section * biquadCoeffs + i].c_.real(), initialized );
+			state[offset + 2 + i] = C(c[i],0);
+		}
+		const auto z1 = state[offset].c_;
+		const auto z2 = state[offset + 1].c_;
+		const auto y = c[0] * value + z1;
+		state[offset] = C( c[1] * value - c[3] * y + z2 );
+		state[offset + 1] = C( c[2] * value - c[4] * y );
+		value = y;
+	}
+	return C(value);
+}
+
+/*******************
+ * SvfFunction
+ ******************/
+
+SvfFunction::SvfFunction()
+	: exprtk::igeneric_function<C>("TTTV")
+{}
+
+C SvfFunction::operator()(parameter_list_t parameters)
+{
+	scalar_t input(parameters[0]);
+	scalar_t cutoff(parameters[1]);
+	scalar_t q(parameters[2]);
+	vector_t state(parameters[3]);
+	if( state.size() < filters::svfStateSize ) {
+		return input();
+	}
+	const bool initialized = intern::initialize( state );
+	// ic1eq, ic2eq, g, k:
+	T g = intern::real( state, 3 );
+	T k = intern::real( state, 4 );
+	intern::smooth(
+			&g,
+			std::tan( std::numbers::pi * intern::normalizedFrequency( cutoff().c_.real() ) ),
+			initialized
+	);
+	intern::smooth( &k, 1 / std::max( q().c_.real(), T(0.01) ), initialized );
+	state[3] = C(g,0);
+	state[4] = C(k,0);
+	const auto ic1eq = state[1].c_;
+	const auto ic2eq = state[2].c_;
+	const T a1 = 1 / (1 + g * (g + k));
+	const T a2 = g * a1;
+	const T a3 = g * a2;
+	const auto v3 = input().c_ - ic2eq;
+	const auto v1 = a1 * ic1eq + a2 * v3;
+	const auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+	state[1] = C( T(2) * v1 - ic1eq );
+	state[2] = C( T(2) * v2 - ic2eq );
+	// real part of the input only,
+	// both outputs fit one value:
+	return C( v2.real(), v1.real() );
+}
@@ -1,4 +1,7 @@
 #include "fge/model/function.h"
+#include "fge/model/delay_line.h"
+#include "fge/model/function_builtins.h"
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <QDebug>
@@ -55,7 +58,9 @@ Function::~Function()
 
 C Function::operator()(const C& x)
 {
-	 return this->get( x );
+	// called from other functions:
+	ProfileScope scope( profileSlot );
+	return this->get( x );
 }
 
 /*******************
@@ -84,7 +89,11 @@ QString FormulaFunction::toString() const {
 
 ParameterBindings FormulaFunction::getParameters() const
 {
-	return parameters;
+	ParameterBindings ret;
+	for( ParameterHandle i=0; i<parameterNames.size(); i++ ) {
+		ret.insert( ret.end(), { parameterNames[i], parameterValues[i] } );
+	}
+	return ret;
 }
 
 MaybeError FormulaFunction::setParameter(
@@ -92,23 +101,79 @@ MaybeError FormulaFunction::setParameter(
 		const C& value
 )
 {
-	auto entry = parameters.find( name );
-	if( entry == parameters.end() ) {
+	auto handle = getParameterHandle( name );
+	if( !handle ) {
 		return QString("Parameter not found: '%1'").arg( name );
 	}
-	entry->second = value;
+	setParameter( handle.value(), value );
 	return {};
 }
 
+std::optional<ParameterHandle> FormulaFunction::getParameterHandle(
+		const QString& name
+) const
+{
+	auto entry = std::ranges::lower_bound( parameterNames, name );
+	if( entry == parameterNames.end() || *entry != name ) {
+		return {};
+	}
+	return ParameterHandle( entry - parameterNames.begin() );
+}
+
+C FormulaFunction::getParameter(
+		const ParameterHandle handle
+) const
+{
+	if( handle >= parameterValues.size() ) {
+		return C(0,0);
+	}
+	return parameterValues[handle];
+}
+
+void FormulaFunction::setParameter(
+		const ParameterHandle handle,
+		const C& value
+)
+{
+	if( handle >= parameterValues.size() ) {
+		return;
+	}
+	parameterValues[handle] = value;
+}
+
 StateDescriptions FormulaFunction::getStateDescriptions() const
 {
 	return stateDescriptions;
 }
 
+void FormulaFunction::saveState( StateArena::Snapshot* snapshot ) const
+{
+	state.save( snapshot );
+}
+
+void FormulaFunction::restoreState( const StateArena::Snapshot& snapshot )
+{
+	state.restore( snapshot );
+}
+
+size_t FormulaFunction::getStateBytes() const
+{
+	return state.bytes();
+}
+
 void FormulaFunction::resetState()
 {
-	for( auto& [name, value] : state ) {
-		value.assign( value.size(), C(0,0) );
+	state.reset();
+	if( builtins ) {
+		builtins->reset();
+	}
+}
+
+void FormulaFunction::setSeed( const uint64_t seed )
+{
+	this->seed = seed;
+	if( builtins ) {
+		builtins->setSeed( mixSeed( seedFromString( formulaStr ), seed ) );
 	}
 }
 
@@ -120,37 +185,77 @@ MaybeError FormulaFunction::init(
 )
 {
 	this->formulaStr = formulaStr;
-	this->parameters = parameters;
 	this->stateDescriptions = stateDescrs;
 
-	for( auto [name, descr] : stateDescrs )
+	// (`std::map` is sorted by name):
+	for( const auto& [name, value] : parameters ) {
+		parameterNames.push_back( name );
+		parameterValues.push_back( value );
+	}
+	std::vector<size_t> stateOffsets;
+	std::vector<size_t> stateSizes;
+	for( const auto& [name, descr] : stateDescrs )
 	{
-		std::vector<C> vector(descr.size, C(0,0) );
-		this->state.insert( { name, vector } );
+		stateSizes.push_back(
+				(descr.kind == StateKind::Delay)
+				? delay_line::stateSize( descr.size )
+				: descr.size
+		);
+		stateOffsets.push_back( state.allocate( stateSizes.back() ) );
 	}
+	state.commit();
 
 	// build symbol table
 	// add "x" and parameters:
 	symbol_table_t symbols;
 	symbols.add_variable( "x", varX );
 	// parameters:
-	for( auto& [paramName, paramValue] : this->parameters ) {
+	for( ParameterHandle i=0; i<parameterNames.size(); i++ ) {
 		symbols.add_variable(
-				paramName.toStdString(),
-				paramValue
+				parameterNames[i].toStdString(),
+				parameterValues[i]
 		);
 	}
 	// add state:
-	for( auto& [key, value] : this->state ) {
-		if( stateDescriptions[key].size == 1 ) {
-			symbols.add_variable( key.toStdString(), value.at(0) );
+	{
+		uint i = 0;
+		for( const auto& [key, descr] : stateDescriptions ) {
+			auto value = state.data( stateOffsets[i] );
+			const auto size = stateSizes[i];
+			i++;
+			if( size == 1 ) {
+				symbols.add_variable( key.toStdString(), *value );
+			}
+			else {
+				symbols.add_vector( key.toStdString(), value, size );
+			}
+		}
+	}
+	// builtins with state:
+	builtins = std::make_unique<FunctionBuiltins>( mixSeed( seedFromString( formulaStr ), seed ) );
+	// evaluation must not allocate,
+	// prepare convolution kernels now:
+	for( const auto& name : convolveKernelNames( formulaStr ) ) {
+		const auto it = stateDescriptions.find( name );
+		if( it == stateDescriptions.end() ) {
+			continue;
+		}
+		const auto i = std::distance( stateDescriptions.begin(), it );
+		builtins->prepareConvolution( state.data( stateOffsets[i] ), stateSizes[i] );
+	}
+	// and fft plans:
+	for( const auto& name : fftOutputNames( formulaStr ) ) {
+		const auto it = stateDescriptions.find( name );
+		if( it != stateDescriptions.end() ) {
+			builtins->prepareFFT( stateSizes[ std::distance( stateDescriptions.begin(), it ) ] );
 		}
-		else {
-			symbols.add_vector( key.toStdString(), value );
+		else if( const auto size = localVectorSize( formulaStr, name ) ) {
+			builtins->prepareFFT( size.value() );
 		}
 	}
 	// add additional symbols:
 	formula.register_symbol_table( symbols );
+	formula.register_symbol_table( builtins->symbols() );
 	for( auto additional : additionalSymbols ) {
 		formula.register_symbol_table( additional.get() );
 	}
@@ -0,0 +1,48 @@
+#include "fge/model/function_builtins.h"
+
+
+FunctionBuiltins::FunctionBuiltins( const uint64_t seed )
+	: fft( &fftPlans, false )
+	, ifft( &fftPlans, true )
+	, seed( seed )
+	, random( seed )
+	, rnd( &random )
+	, rndNormal( &random )
+	, rndFill( &random )
+	, rndNormalFill( &random )
+{
+	symbolTable.add_function( "convolve", convolve );
+	symbolTable.add_function( "fft", fft );
+	symbolTable.add_function( "ifft", ifft );
+	symbolTable.add_function( "rnd", rnd );
+	symbolTable.add_function( "rnd_normal", rndNormal );
+	symbolTable.add_function( "rnd_fill", rndFill );
+	symbolTable.add_function( "rnd_normal_fill", rndNormalFill );
+}
+
+symbol_table_t& FunctionBuiltins::symbols()
+{
+	return symbolTable;
+}
+
+void FunctionBuiltins::reset()
+{
+	convolve.reset();
+	random.seed( seed );
+}
+
+void FunctionBuiltins::prepareConvolution( const C* kernel, const size_t size )
+{
+	convolve.prepare( kernel, size );
+}
+
+void FunctionBuiltins::prepareFFT( const size_t size )
+{
+	fftPlans.prepare( size );
+}
+
+void FunctionBuiltins::setSeed( const uint64_t seed )
+{
+	this->seed = seed;
+	random.seed( seed );
+}
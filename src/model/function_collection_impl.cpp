@@ -1,4 +1,7 @@
 #include "fge/model/function_collection_impl.h"
+#include "fge/model/delay_line.h"
+#include "fge/model/filters.h"
+#include "fge/model/oscillators.h"
 #include "include/fge/model/function.h"
 #include "include/fge/model/function_collection.h"
 #include <exprtk.hpp>
@@ -52,12 +55,8 @@ DECL_FUNC_BEGIN(ComplexMod,2,const C& x1, const C& x2)
 	return C(fmod(x1.c_.real(), x2.c_.real()), fmod(x1.c_.imag(),x2.c_.imag()));
 DECL_FUNC_END(ComplexMod)
 
-DECL_FUNC_BEGIN(RandomFunction,0,)
-	return C(T(std::rand())/T(RAND_MAX), 0);
-DECL_FUNC_END(RandomFunction)
-
 DECL_FUNC_BEGIN(MidiToFreq,1,const C& x)
-	return C( 440.0 * powf(2,1.0/12.0 * (x.c_.real()-69.0)) ,0);
+	return C( 440.0 * std::exp2( (x.c_.real()-69.0) / 12.0 ), 0);
 DECL_FUNC_END(MidiToFreq)
 
 DECL_FUNC_BEGIN(Real_Compare,2,const C& x1, const C& x2)
@@ -164,10 +163,16 @@ static auto complexFunc = ComplexFunction();
 static auto polarFunc = PolarFunction();
 static auto realCompare = Real_Compare();
 static auto complexMod = ComplexMod();
-static auto randomFunc = RandomFunction();
 static auto mtof = MidiToFreq();
 static auto bitinv = BitInversion();
 static auto bit_rev_copy = BitRevCopy();
+static auto onePoleFunc = OnePoleFunction();
+static auto biquadFunc = BiquadFunction();
+static auto svfFunc = SvfFunction();
+static auto delayWriteFunc = DelayWriteFunction();
+static auto delayReadFunc = DelayReadFunction();
+static auto harmonicsFunc = HarmonicsFunction();
+static auto phasorFunc = PhasorFunction();
 
 Symbols symbols()
 {
@@ -190,10 +195,16 @@ Symbols symbols()
 			{ "polar", &polarFunc },
 			{ "real_cmp", &realCompare },
 			{ "c_mod", &complexMod },
-			{ "rnd", &randomFunc },
 			{ "mtof", &mtof },
 			{ "bitinv", &bitinv },
-			{ "bitrevcpy", &bit_rev_copy }
+			{ "bitrevcpy", &bit_rev_copy },
+			{ "onepole", &onePoleFunc },
+			{ "biquad", &biquadFunc },
+			{ "svf", &svfFunc },
+			{ "delay_write", &delayWriteFunc },
+			{ "delay_read", &delayReadFunc },
+			{ "harmonics", &harmonicsFunc },
+			{ "phasor", &phasorFunc }
 		}
 	);
 }
@@ -226,11 +237,30 @@ FunctionOrError FunctionCollectionImpl::getFunction(const Index index) const
 		});
 }
 
+Function* FunctionCollectionImpl::getFunctionRaw(const Index index) const
+{
+	const auto& entry = entries.at( index );
+	if( !entry->functionOrError ) {
+		return nullptr;
+	}
+	return entry->functionOrError.value().function.get();
+}
+
+Function* FunctionCollectionImpl::getGraphFunctionRaw(const Index index) const
+{
+	const auto& entry = entries.at( index );
+	if( !entry->functionOrError ) {
+		return nullptr;
+	}
+	return entry->functionOrError.value().graphFunction.get();
+}
+
 FunctionInfo FunctionCollectionImpl::getFunctionInfo(const uint index) const
 {
 	auto entry = entries.at( index );
 	if( entry->functionOrError ) {
-		auto function = entry->functionOrError.value().function;
+		// not touched by the audio (ramps):
+		auto function = entry->functionOrError.value().graphFunction;
 		auto parameterDescriptions = entry->functionOrError.value().parameterDescriptions;
 		return FunctionInfo{
 			.formula = function->toString(),
@@ -306,8 +336,8 @@ MaybeError FunctionCollectionImpl::setParameterValues(
 	if( !functionOrError ) {
 		return functionOrError.error();
 	}
-	{
-		auto function = functionOrError.value();
+	const auto& entry = entries.at(index)->functionOrError.value();
+	for( auto function : { entry.function, entry.graphFunction } ) {
 		for( auto [key, val] : parameters ) {
 			auto maybeError = function->setParameter( key, val );
 			if( maybeError ) {
@@ -329,6 +359,8 @@ void FunctionCollectionImpl::updateFormulas(
 )
 {
 	Symbols functionSymbols;
+	// graph instances call graph instances:
+	Symbols graphSymbols;
 	/* dont change entries
 	 * before start index
 	 * but add their
@@ -341,6 +373,10 @@ void FunctionCollectionImpl::updateFormulas(
 					functionName( i ),
 					entry->functionOrError.value().function.get()
 			);
+			graphSymbols.addFunction(
+					functionName( i ),
+					entry->functionOrError.value().graphFunction.get()
+			);
 		}
 	}
 	/* update entries
@@ -353,21 +389,33 @@ void FunctionCollectionImpl::updateFormulas(
 		if( i==startIndex && functionInfo ) {
 			currentFunctionInfo = functionInfo.value();
 		}
-		entry->functionOrError = formulaFunctionFactory(
-				currentFunctionInfo.formula,
-				currentFunctionInfo.parameters,
-				currentFunctionInfo.stateDescriptions,
-				{
-					constants,
-					functionSymbols
-				},
-				samplingSettings
-		)
-			.transform([&currentFunctionInfo](auto function) -> ValidEntry {
-					return ValidEntry{
-						.function = function,
-						.parameterDescriptions = currentFunctionInfo.parameterDescriptions
-					};
+		const auto compile = [&](Symbols& functionSymbols) {
+			return formulaFunctionFactory(
+					currentFunctionInfo.formula,
+					currentFunctionInfo.parameters,
+					currentFunctionInfo.stateDescriptions,
+					{
+						constants,
+						functionSymbols
+					},
+					samplingSettings
+			).transform([i](auto function) {
+					// identical formulas in different
+					// slots draw different numbers:
+					function->setSeed( i );
+					return function;
+			});
+		};
+		entry->functionOrError = compile( functionSymbols )
+			.and_then([&](auto function) {
+					return compile( graphSymbols )
+						.transform([&](auto graphFunction) -> ValidEntry {
+								return ValidEntry{
+									.function = function,
+									.graphFunction = graphFunction,
+									.parameterDescriptions = currentFunctionInfo.parameterDescriptions
+								};
+						});
 			})
 			.transform_error([&currentFunctionInfo, &samplingSettings](auto error) -> InvalidEntry {
 				return InvalidEntry{
@@ -392,6 +440,10 @@ void FunctionCollectionImpl::updateFormulas(
 					functionName( i ),
 					entry->functionOrError.value().function.get()
 			);
+			graphSymbols.addFunction(
+					functionName( i ),
+					entry->functionOrError.value().graphFunction.get()
+			);
 		}
 	}
 }
@@ -423,6 +475,7 @@ void FunctionCollectionImpl::setSamplingSettings(
 {
 	if( auto function = entries.at(index)->functionOrError; function.has_value() ) {
 			function.value().function->setSamplingSettings( value );
+			function.value().graphFunction->setSamplingSettings( value );
 	}
 	else {
 		auto invalid = entries.at(index)->functionOrError.error();
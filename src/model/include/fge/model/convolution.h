@@ -0,0 +1,95 @@
+#pragma once
+
+#include "fge/model/fft.h"
+#include <vector>
+
+
+/**
+ * Uniformly partitioned overlap-save
+ * FFT convolution, processing one
+ * sample at a time.
+ * The kernel is split into partitions
+ * of `blockSize` taps, whose spectra are
+ * precomputed. Each block of input
+ * costs one FFT, one IFFT (of size
+ * 2*blockSize) and one complex multiply
+ * accumulate per partition.
+ *
+ * Latency: `blockSize` samples.
+ */
+class PartitionedConvolution
+{
+	public:
+		using value_t = FFTPlan::value_t;
+
+	public:
+		explicit PartitionedConvolution(
+				const size_t blockSize = 128
+		);
+
+		// (re-)compute kernel spectra.
+		// keeps the input history if
+		// the number of partitions stays the same:
+		void setKernel( const C* kernel, const size_t size );
+		bool kernelEquals( const C* kernel, const size_t size ) const;
+
+		C process( const C& input );
+		void reset();
+
+		bool atBlockStart() const { return pos == 0; }
+		size_t latency() const { return blockSize; }
+
+	private:
+		void processBlock();
+
+	private:
+		const size_t blockSize;
+		FFTPlan plan;
+		std::vector<value_t> kernel;
+		// one spectrum per partition:
+		std::vector<std::vector<value_t>> kernelSpectra;
+		// frequency domain delay line:
+		std::vector<std::vector<value_t>> inputSpectra;
+		size_t fdlPos = 0;
+		// previous and current input block:
+		std::vector<value_t> inputBuffer;
+		std::vector<value_t> outputBlock;
+		std::vector<value_t> accumulator;
+		size_t pos = 0;
+};
+
+/**
+ * exprtk builtin:
+ *   convolve( signal_value, kernel_vector )
+ * Call once per sample with the
+ * current input value, returns the
+ * convolved (delayed) output.
+ * State is kept per kernel vector,
+ * so every kernel may be used in one
+ * `convolve` call per formula.
+ * The kernel must be a state vector,
+ * prepared when the formula is compiled
+ * (evaluation doesn't allocate).
+ * Other kernels yield 0.
+ */
+struct ConvolveFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	ConvolveFunction();
+
+	// allocate for `kernel` (not realtime safe):
+	void prepare( const C* kernel, const size_t size );
+
+	C operator()(parameter_list_t parameters) override;
+	void reset();
+
+	private:
+		std::vector<std::pair<const C*,std::unique_ptr<PartitionedConvolution>>> instances;
+};
+
+/* plain names passed as kernel
+ * to `convolve` in `formula`:
+ */
+std::vector<QString> convolveKernelNames( const QString& formula );
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "fge/model/function.h"
+
+
+/**
+ * Delay lines as exprtk builtins,
+ * O(1) per sample.
+ * The ring buffer is a state vector
+ * of the calling function:
+ *   d[0]: write position
+ *   d[1..]: power of two samples
+ * State declared as `delay <size> <name>`
+ * is allocated that way (size rounded up).
+ * Plain state vectors work as well,
+ * using the largest power of two
+ * that fits.
+ *
+ *   delay_write( value, d ): returns `value`
+ *   delay_read( samples, d ):
+ *     the value written `samples` writes ago,
+ *     linear interpolation between samples.
+ *     Read before writing the current sample:
+ *     `delay_read(1,d)` is the previous one.
+ *     `samples` is clamped to [1, capacity],
+ *     the minimum delay is 1.
+ */
+namespace delay_line {
+
+	constexpr size_t headerSize = 1;
+
+	// state to allocate for a delay of `size` samples:
+	size_t stateSize( const size_t size );
+
+} // namespace delay_line
+
+struct DelayWriteFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	DelayWriteFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
+
+struct DelayReadFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	DelayReadFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <complex>
+#include <memory>
+#include <optional>
+#include <vector>
+
+
+/**
+ * Precomputed FFT of a fixed size.
+ * Powers of 2: iterative radix-2
+ * with tabulated twiddles and
+ * bit reversal permutation.
+ * Other sizes: Bluestein's algorithm
+ * on top of a power of 2 plan.
+ *
+ * Not thread safe (keeps scratch memory),
+ * use one plan per thread.
+ */
+class FFTPlan
+{
+	public:
+		using value_t = std::complex<T>;
+
+	public:
+		explicit FFTPlan( const size_t size );
+
+		size_t size() const { return n; }
+
+		/* in place, unnormalized:
+		 *   X[k] = sum_j x[j] exp(-2pi i jk/N)
+		 */
+		void forward( value_t* data );
+		/* in place, normalized by 1/N,
+		 * so that inverse(forward(x)) == x:
+		 */
+		void inverse( value_t* data );
+
+	private:
+		void radix2( value_t* data ) const;
+		void bluestein( value_t* data );
+
+	private:
+		size_t n;
+		bool isPow2;
+		// radix-2:
+		std::vector<uint32_t> bitReversed;
+		std::vector<value_t> twiddles;
+		// bluestein:
+		std::vector<value_t> chirp;
+		std::vector<value_t> chirpSpectrum;
+		std::unique_ptr<FFTPlan> inner;
+		std::vector<value_t> scratch;
+};
+
+/**
+ * Per thread cache of plans.
+ * Creating a plan allocates,
+ * subsequent lookups of the same
+ * size do not.
+ */
+FFTPlan& fftPlan( const size_t size );
+
+/* convenience for exprtk vectors:
+ * `in` is zero padded or truncated
+ * to the size of `out`:
+ */
+void fft(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize
+);
+
+void ifft(
+		C* out, const size_t outSize,
+		const C* in, const size_t inSize
+);
+
+/**
+ * Plans by size, with scratch
+ * memory, for the `fft` and `ifft`
+ * builtins of one formula.
+ */
+class FFTPlans
+{
+	public:
+		// allocates (not realtime safe):
+		void prepare( const size_t size );
+		/* like `fft` / `ifft` above.
+		 * Sizes not prepared are
+		 * planned here, which allocates:
+		 */
+		void transform(
+				C* out, const size_t outSize,
+				const C* in, const size_t inSize,
+				const bool inverse
+		);
+
+	private:
+		struct Entry {
+			std::unique_ptr<FFTPlan> plan;
+			std::vector<FFTPlan::value_t> work;
+		};
+		Entry& entry( const size_t size );
+
+	private:
+		// few sizes per formula:
+		std::vector<Entry> entries;
+};
+
+/**
+ * exprtk builtins:
+ *   fft( out_vector, in_vector )
+ *   ifft( out_vector, in_vector )
+ * `in` is zero padded or truncated
+ * to the size of `out`, returns 0.
+ * Output vectors should be state vectors
+ * or local vectors of literal size
+ * (`var v[8]`), whose plans are prepared
+ * when the formula is compiled
+ * (evaluation doesn't allocate).
+ */
+struct FFTFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	FFTFunction( FFTPlans* plans, const bool inverse );
+
+	C operator()(parameter_list_t parameters) override;
+
+	private:
+		FFTPlans* plans;
+		bool inverse;
+};
+
+/* plain names passed as output
+ * vector to `fft` or `ifft` in `formula`:
+ */
+std::vector<QString> fftOutputNames( const QString& formula );
+
+/* size of the local vector `name`,
+ * if declared with a literal size
+ * (`var name[8]`) in `formula`:
+ */
+std::optional<size_t> localVectorSize(
+		const QString& formula,
+		const QString& name
+);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "fge/model/function.h"
+
+
+/**
+ * Recursive filters as exprtk builtins,
+ * processing one sample per call.
+ * The builtins themselves are stateless:
+ * the filter memory is a state vector
+ * of the calling function (`s` below),
+ * so every call site needs its own.
+ * The state vector also holds smoothed
+ * coefficients: changes of the
+ * coefficients glide over a few
+ * milliseconds instead of clicking.
+ * Resetting the function state resets
+ * the filters. State vectors which are
+ * too small leave the input unchanged.
+ *
+ * Frequencies are normalized:
+ * cutoff in Hz / samplerate.
+ */
+namespace filters {
+
+	// coefficients approach their targets
+	// by this fraction per sample:
+	constexpr T smoothing = 0.005;
+
+	/* s[0]: 1 once initialized.
+	 * every filter starts with its
+	 * target coefficients:
+	 */
+	constexpr size_t headerSize = 1;
+
+	/* onepole( input, cutoff, s )
+	 * lowpass, |s| >= 3
+	 */
+	constexpr size_t onePoleStateSize = headerSize + 2;
+
+	/* biquad( input, coeffs, s )
+	 * cascade of sections,
+	 * transposed direct form II.
+	 * coeffs: b0,b1,b2,a1,a2 per section
+	 * (a0 normalized to 1),
+	 * |s| >= 1 + 7 * sections
+	 */
+	constexpr size_t biquadCoeffs = 5;
+	constexpr size_t biquadSectionStateSize = 2 + biquadCoeffs;
+
+	/* svf( input, cutoff, q, s )
+	 * trapezoidal state variable filter,
+	 * returns complex( lowpass, bandpass ),
+	 * highpass = input - bandpass/q - lowpass.
+	 * |s| >= 5
+	 */
+	constexpr size_t svfStateSize = headerSize + 4;
+
+} // namespace filters
+
+struct OnePoleFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	OnePoleFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
+
+struct BiquadFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	BiquadFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
+
+struct SvfFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	SvfFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
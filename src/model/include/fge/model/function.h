@@ -1,8 +1,11 @@
 #pragma once
 
 #include "fge/model/cache.h"
+#include "fge/model/state_arena.h"
 #include "fge/shared/data.h"
+#include "fge/shared/profiler.h"
 #include "exprtk.hpp"
+#include <memory>
 
 typedef exprtk::symbol_table<C>
 	symbol_table_t;
@@ -45,6 +48,18 @@ public exprtk::ifunction<C>
 				const QString& name,
 				const C& value
 		) = 0;
+		// realtime safe access by handle
+		// (invalid handles are ignored):
+		virtual std::optional<ParameterHandle> getParameterHandle(
+				const QString& name
+		) const = 0;
+		virtual C getParameter(
+				const ParameterHandle handle
+		) const = 0;
+		virtual void setParameter(
+				const ParameterHandle handle,
+				const C& value
+		) = 0;
 		virtual StateDescriptions getStateDescriptions() const = 0;
 
 		C operator()(const C& x);
@@ -54,6 +69,25 @@ public exprtk::ifunction<C>
 
 		virtual void update() = 0;
 		virtual void resetState() = 0;
+		/* e.g. to evaluate without
+		 * disturbing the audio:
+		 */
+		virtual void saveState( StateArena::Snapshot* snapshot ) const = 0;
+		virtual void restoreState( const StateArena::Snapshot& snapshot ) = 0;
+		virtual size_t getStateBytes() const = 0;
+		/* random builtins start from a seed
+		 * mixed from the formula and `seed`
+		 * (e.g. the slot of the function):
+		 */
+		virtual void setSeed( const uint64_t seed ) = 0;
+
+		// where to account evaluation time
+		// (`nullptr`: not profiled):
+		ProfileSlot* getProfileSlot() const { return profileSlot; }
+		void setProfileSlot( ProfileSlot* slot ) { profileSlot = slot; }
+
+	private:
+		ProfileSlot* profileSlot = nullptr;
 };
 
 /*******************
@@ -91,6 +125,8 @@ const SamplingSettings no_optimization_settings{
 	.buffered = false
 };
 
+class FunctionBuiltins;
+
 class FormulaFunction:
 	virtual public Function
 {
@@ -107,9 +143,23 @@ class FormulaFunction:
 				const QString& name,
 				const C& value
 		) override;
+		virtual std::optional<ParameterHandle> getParameterHandle(
+				const QString& name
+		) const override;
+		virtual C getParameter(
+				const ParameterHandle handle
+		) const override;
+		virtual void setParameter(
+				const ParameterHandle handle,
+				const C& value
+		) override;
 		virtual StateDescriptions getStateDescriptions() const override;
 
 		virtual void resetState() override;
+		virtual void saveState( StateArena::Snapshot* snapshot ) const override;
+		virtual void restoreState( const StateArena::Snapshot& snapshot ) override;
+		virtual size_t getStateBytes() const override;
+		virtual void setSeed( const uint64_t seed ) override;
 		virtual void update() override {};
 
 		virtual SamplingSettings getSamplingSettings() const override {
@@ -128,11 +178,16 @@ class FormulaFunction:
 
 	private:
 		QString formulaStr;
-		ParameterBindings parameters;
+		// sorted by name, indexed by handle.
+		// fixed size: exprtk refers to the values:
+		std::vector<QString> parameterNames;
+		std::vector<C> parameterValues;
 		StateDescriptions stateDescriptions;
-		StateBindings state;
+		StateArena state;
 		expression_t formula;
 		C varX;
+		uint64_t seed = 0;
+		std::unique_ptr<FunctionBuiltins> builtins;
 };
 
 /*******************
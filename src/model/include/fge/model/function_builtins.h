@@ -0,0 +1,43 @@
+#pragma once
+
+#include "fge/model/function.h"
+#include "fge/model/convolution.h"
+#include "fge/model/fft.h"
+#include "fge/model/random.h"
+
+
+/**
+ * Builtins keeping state
+ * between calls (e.g. filters).
+ * Unlike the global `symbols()`
+ * every FormulaFunction owns
+ * its own instance, state is
+ * reset with the function state.
+ */
+class FunctionBuiltins
+{
+	public:
+		// random numbers restart from `seed` on `reset`:
+		explicit FunctionBuiltins( const uint64_t seed = 0 );
+
+		symbol_table_t& symbols();
+		void reset();
+		void setSeed( const uint64_t seed );
+		// allocates for `convolve( ..., kernel )`:
+		void prepareConvolution( const C* kernel, const size_t size );
+		// allocates for `fft`/`ifft` of `size`:
+		void prepareFFT( const size_t size );
+
+	private:
+		symbol_table_t symbolTable;
+		ConvolveFunction convolve;
+		FFTPlans fftPlans;
+		FFTFunction fft;
+		FFTFunction ifft;
+		uint64_t seed;
+		Random random;
+		RandomFunction rnd;
+		NormalRandomFunction rndNormal;
+		RandomFillFunction<false> rndFill;
+		RandomFillFunction<true> rndNormalFill;
+};
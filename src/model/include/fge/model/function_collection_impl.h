@@ -16,6 +16,10 @@ class FunctionCollectionImpl:
 		struct ValidEntry
 		{
 			std::shared_ptr<Function> function;
+			/* same formula, own state,
+			 * for sampling graphs:
+			 */
+			std::shared_ptr<Function> graphFunction;
 			ParameterDescriptions parameterDescriptions;
 		};
 		struct InvalidEntry
@@ -45,6 +49,9 @@ class FunctionCollectionImpl:
 		virtual void resize( const uint size ) override;
 
 		virtual std::expected<std::shared_ptr<Function>,Error> getFunction(const Index index) const override;
+		// no refcounting, `nullptr` if invalid:
+		Function* getFunctionRaw(const Index index) const;
+		Function* getGraphFunctionRaw(const Index index) const;
 		virtual MaybeError set(
 				const Index index,
 				const FunctionInfo& functionInfo
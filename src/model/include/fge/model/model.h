@@ -12,8 +12,23 @@ struct AudioScheduled
 	virtual void setAudioSchedulingEnabled(
 			const bool value
 	) = 0;
+	/* returns immediately, `done` is
+	 * called after fading in/out
+	 * (see `Model::bulkUpdateAsync`):
+	 */
+	virtual void setAudioSchedulingEnabledAsync(
+			const bool value,
+			std::function<void()> done
+	) = 0;
 	virtual double getPosition() const = 0;
 	virtual uint getSamplerate() const = 0;
+	// blocks rendered as silence
+	// while an expensive update was running:
+	virtual uint64_t getSilentBlockCount() const = 0;
+	// restart the function state
+	// of the audio (by the audio
+	// thread, between blocks):
+	virtual void resetAudioState() = 0;
 
 	virtual void betweenAudio(
 			const PlaybackPosition position,
@@ -39,6 +54,14 @@ struct Model:
 		ParameterBindings parameters
 		)>
 	;
+	using UpdateDone = std::function<void(
+		MaybeError maybeError
+		)>
+	;
+	using ResizeDone = std::function<void(
+		const uint previousSize
+		)>
+	;
 
 	virtual ~Model() {};
 
@@ -47,6 +70,27 @@ struct Model:
 			const Update& update
 	) = 0;
 
+	/* Non blocking variants:
+	 * return as soon as the update is
+	 * scheduled. Updates take place in
+	 * the order they were issued.
+	 * `done` is called afterwards,
+	 * from the model worker thread
+	 * if audio scheduling is enabled,
+	 * otherwise before returning.
+	 * `done` must not call blocking
+	 * model methods.
+	 */
+	virtual void bulkUpdateAsync(
+			const Index index,
+			const Update& update,
+			UpdateDone done
+	) = 0;
+	virtual void resizeAsync(
+			const uint size,
+			ResizeDone done
+	) = 0;
+
 	virtual void prepareResize() = 0;
 	virtual void prepareSet(const Index index) = 0;
 	virtual void prepareSetParameterValues(const Index index) = 0;
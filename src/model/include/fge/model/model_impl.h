@@ -6,6 +6,7 @@
 #include "fge/shared/concurrency_utils.h"
 #include "template_utils.h"
 // #include <future>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <optional>
@@ -91,13 +92,18 @@ struct Ramping {
 	{
 		Index index;
 		QString parameterName;
+		// resolved when the ramp starts,
+		// pending updates might change
+		// the parameters until then:
+		ParameterHandle parameter = 0;
 		double src;
 		double dst;
 		std::optional<PlaybackPosition> pos = {};
 		bool done = false;
 		bool succeeded = false;
 		ParameterSignalDone signalizeDone;
-		std::vector<Index> delayedUpdates;
+		// collected when the ramp starts:
+		std::optional<std::vector<Index>> delayedUpdates = {};
 	};
 	public:
 		template <typename TaskQueue>
@@ -105,6 +111,17 @@ struct Ramping {
 				TaskQueue& tasksQueue,
 				double value
 		);
+		/* ramp the master envelope to 0,
+		 * unless it is (or will be) at 0 already.
+		 * Consecutive edits share the fade and
+		 * their setters stay adjacent in the queue,
+		 * so the model worker runs them as one batch:
+		 */
+		template <typename TaskQueue>
+		static void fadeOut(
+				TaskQueue& tasksQueue,
+				const std::shared_ptr<SampledFunctionCollectionImpl> network
+		);
 		template <typename TaskQueue>
 		static void rampEntry(
 				TaskQueue& tasksQueue,
@@ -132,11 +149,14 @@ struct Ramping {
 				const uint samplerate
 		);
 	private:
-		template <typename Task, typename View>
+		// getValue: double(const Task*),
+		// setValue: void(Task*, const double)
+		// (no std::function, called per sample):
+		template <typename Task, typename View, typename GetValue, typename SetValue>
 		static void updateRamp(
 				View view,
-				std::function<double(const Task* task)> getValue,
-				std::function<void(Task* task,const double)> setValue,
+				GetValue getValue,
+				SetValue setValue,
 				const PlaybackPosition position,
 				const uint samplerate
 		);
@@ -173,6 +193,8 @@ class ScheduledFunctionCollectionImpl:
 				const unsigned int resolution
 		) const override;
 
+		virtual std::vector<NodeStatistics> getNodeStatistics() const override;
+
 		virtual double getPlaybackSpeed() const override;
 
 		virtual PlaybackSettings getPlaybackSettings(
@@ -185,6 +207,8 @@ class ScheduledFunctionCollectionImpl:
 
 		virtual double getPosition() const override;
 		virtual uint getSamplerate() const override;
+		virtual uint64_t getSilentBlockCount() const override;
+		virtual void resetAudioState() override;
 
 		// WRITE:
 
@@ -201,8 +225,19 @@ class ScheduledFunctionCollectionImpl:
 				const Update& update
 		) override;
 
+		virtual void bulkUpdateAsync(
+				const Index index,
+				const Update& update,
+				UpdateDone done
+		) override;
+
 		virtual void resize( const uint size ) override;
 
+		virtual void resizeAsync(
+				const uint size,
+				ResizeDone done
+		) override;
+
 		virtual MaybeError set(
 				const Index index,
 				const QString& formula,
@@ -243,12 +278,21 @@ class ScheduledFunctionCollectionImpl:
 				const SamplingSettings& value
 		) override;
 
+		virtual void setSampleTap(
+				const Index index,
+				std::shared_ptr<SampleTap> tap
+		) override;
+
 		// Control Scheduling:
 
 		virtual bool getAudioSchedulingEnabled() const override;
 		virtual void setAudioSchedulingEnabled(
 				const bool value
 		) override;
+		virtual void setAudioSchedulingEnabledAsync(
+				const bool value,
+				std::function<void()> done
+		) override;
 
 		virtual void valuesToBuffer(
 				std::vector<float>* buffer,
@@ -266,9 +310,10 @@ class ScheduledFunctionCollectionImpl:
 		using RampMasterEnvTask = Ramping::RampMasterEnvTask;
 		using RampMasterVolumeTask = Ramping::RampMasterVolumeTask;
 		using RampParameterTask = Ramping::RampParameterTask;
+		// called by the model worker:
 		struct SignalReturnTask
 		{
-			std::promise<void> promise;
+			TaskDoneCallback signalDone;
 			bool done = false;
 		};
 	private:
@@ -289,20 +334,45 @@ class ScheduledFunctionCollectionImpl:
 
 	private:
 
-		const mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>>* getNetworkConst() const {
+		const shared_mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>>* getNetworkConst() const {
 			return &(this->guardedNetwork);
 		}
-		mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>>* getNetwork() {
+		shared_mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>>* getNetwork() {
 			return &(this->guardedNetwork);
 		}
+		PlaybackPosition currentPosition() const {
+			return clock.read().position;
+		}
 		void modelWorkerLoop();
+		// `writeTasks` locked by the caller:
+		void fadeOut( std::deque<WriteTask>& tasksQueue );
 
 	private:
-		bool audioSchedulingEnabled = false;
-		std::atomic<PlaybackPosition> position = 0;
-		std::atomic<uint> samplerate = 0;
+		// written by the audio thread only:
+		struct PlaybackClock {
+			PlaybackPosition position = 0;
+			uint samplerate = 0;
+		};
 
-		mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>> guardedNetwork;
+	private:
+		// switched off by the model worker
+		// after fading out:
+		std::atomic<bool> audioSchedulingEnabled = false;
+		seqlock_guarded<PlaybackClock> clock;
+
+		/* `read` (shared): plain queries,
+		 * the audio and graphs. Evaluation
+		 * has side effects on function state,
+		 * but the audio and graphs use
+		 * separate instances (graphs
+		 * serialized by the network).
+		 * The audio thread is the only one
+		 * to touch audio instances, envelopes
+		 * and master volume.
+		 * `write`: anything else changing
+		 * the network.
+		 */
+		shared_mutex_guarded<std::shared_ptr<SampledFunctionCollectionImpl>> guardedNetwork;
 		mutex_guarded<std::deque<WriteTask>> writeTasks;
 
 		std::thread modelWorkerThread;
@@ -315,6 +385,7 @@ class ScheduledFunctionCollectionImpl:
 		} writeTasksSignal;
 
 		std::atomic<bool> expensiveTaskRunning = false;
+		std::atomic<uint64_t> silentBlocks = 0;
 
 	template <auto function>
 	friend struct SetterTask;
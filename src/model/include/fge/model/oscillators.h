@@ -0,0 +1,71 @@
+#pragma once
+
+#include "fge/model/function.h"
+#include <complex>
+
+
+/**
+ * exprtk builtin:
+ *   harmonics( phase, amps )
+ * bank of harmonic partials:
+ *   sum_k amps[k-1] * e^(i 2pi k phase)
+ * for k = 1..|amps|.
+ * `phase` in cycles of the fundamental
+ * (e.g. `440*x`). Amplitudes are complex,
+ * their argument is the phase offset of
+ * the partial. The real part of the result
+ * is the cosine series, the imaginary
+ * part the sine series.
+ * Costs one complex exponential per call
+ * and one complex multiply-add per partial
+ * (evaluated as a polynomial in the
+ * rotation e^(i 2pi phase)).
+ */
+struct HarmonicsFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	HarmonicsFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
+
+/**
+ * exprtk builtin:
+ *   phasor( angle, s )
+ * e^(i angle) = complex( cos(angle), sin(angle) ),
+ * for arguments advancing by a
+ * constant step, as in audio
+ * playback or graph sampling:
+ * if the step matches the previous one,
+ * the result is the previous one rotated
+ * by the step (one complex multiply).
+ * Recomputed exactly on any other step
+ * and every `phasorRenormalize` calls to
+ * bound drift.
+ * `s` is a state vector of the calling
+ * function, |s| >= 4. Smaller vectors
+ * compute every value exactly.
+ */
+struct PhasorFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	PhasorFunction();
+
+	C operator()(parameter_list_t parameters) override;
+};
+
+constexpr size_t phasorStateSize = 4;
+constexpr size_t phasorRenormalize = 64;
+
+/* sum_k coeffs[k-1] * z^k,
+ * for k = 1..size:
+ */
+std::complex<T> harmonicSum(
+		const C* coeffs,
+		const size_t size,
+		const std::complex<T>& z
+);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "fge/model/function.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+
+
+/**
+ * xoshiro256+ pseudo random numbers.
+ * Fast and lock free, not suitable
+ * for cryptography.
+ * Same seed, same sequence.
+ */
+class Random
+{
+	public:
+		explicit Random( const uint64_t seed = 0 );
+
+		void seed( const uint64_t seed );
+
+		// [0,1):
+		T uniform();
+		// standard normal distribution:
+		T normal();
+
+		void fillUniform( C* values, const size_t count );
+		void fillNormal( C* values, const size_t count );
+
+	private:
+		uint64_t next();
+
+	private:
+		std::array<uint64_t,4> state;
+		// normals are generated in pairs:
+		std::optional<T> spareNormal;
+};
+
+/**
+ * exprtk builtins, drawing from
+ * the generator of the function:
+ *   rnd(): uniform in [0,1)
+ *   rnd_normal(): standard normal
+ *   rnd_fill( v ), rnd_normal_fill( v ):
+ *     fill the vector `v` at once
+ */
+struct RandomFunction:
+	public exprtk::ifunction<C>
+{
+	explicit RandomFunction( Random* random );
+	C operator()() override;
+
+	private:
+		Random* random;
+};
+
+struct NormalRandomFunction:
+	public exprtk::ifunction<C>
+{
+	explicit NormalRandomFunction( Random* random );
+	C operator()() override;
+
+	private:
+		Random* random;
+};
+
+template <bool normal>
+struct RandomFillFunction:
+	public exprtk::igeneric_function<C>
+{
+	using parameter_list_t = exprtk::igeneric_function<C>::parameter_list_t;
+
+	explicit RandomFillFunction( Random* random );
+	C operator()(parameter_list_t parameters) override;
+
+	private:
+		Random* random;
+};
+
+// stable over runs and platforms:
+uint64_t seedFromString( const QString& str );
+
+// combine seeds (e.g. formula and slot):
+uint64_t mixSeed( const uint64_t seed, const uint64_t other );
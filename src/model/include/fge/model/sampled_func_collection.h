@@ -1,10 +1,16 @@
 #pragma once
 
 #include "fge/model/function_collection.h"
+#include "fge/shared/spsc_ring_buffer.h"
 
 
 using PlaybackPosition = unsigned long int;
 
+/* output samples of one function,
+ * written by the audio thread:
+ */
+using SampleTap = SpscRingBuffer<float>;
+
 
 /**
 Represents the following concepts:
@@ -93,6 +99,23 @@ struct SampledFunctionCollection
 			const bool value
 	) = 0;
 
+	/***************
+	 * Analysis
+	 ***************/
+
+	// the samples a function contributes
+	// to the audio output
+	// (while playback is enabled).
+	// `nullptr` removes the tap:
+	virtual void setSampleTap(
+			const Index index,
+			std::shared_ptr<SampleTap> tap
+	) = 0;
+
+	// cumulative evaluation costs per function
+	// (audio and graph sampling):
+	virtual std::vector<NodeStatistics> getNodeStatistics() const = 0;
+
 };
 
 struct SampledFunctionCollectionInternal:
@@ -109,6 +132,9 @@ struct SampledFunctionCollectionInternal:
 	virtual double getMasterVolume() const = 0;
 	virtual void setMasterVolume(const double value) = 0;
 
+	// function state of the audio instances:
+	virtual void resetAudioState() = 0;
+
 	using SampledFunctionCollection::valuesToBuffer;
 	// sampling for audio
 	// with an additional
@@ -120,10 +146,28 @@ struct SampledFunctionCollectionInternal:
 			AudioCallback callback
 	) = 0;
 
-	virtual std::pair<MaybeError, std::vector<Index>> setParameterValuesDeferBufferUpdates(
+	/* for parameter ramps, no
+	 * string lookups or allocations:
+	 */
+	virtual std::optional<ParameterHandle> getParameterHandle(
 			const Index index,
-			const ParameterBindings& parameters
+			const QString& name
+	) const = 0;
+	virtual C getParameterValue(
+			const Index index,
+			const ParameterHandle handle
+	) const = 0;
+	// a ramp step: buffers and function
+	// state are left as they are:
+	virtual void setParameterValueDeferBufferUpdates(
+			const Index index,
+			const ParameterHandle handle,
+			const C& value
 	) = 0;
+	// buffered entries `index` affects:
+	virtual std::vector<Index> getBufferedEntries(
+			const Index index
+	) const = 0;
 
 	virtual void updateBuffers(
 			const Index startIndex
@@ -3,9 +3,13 @@
 #include "fge/model/sampled_func_collection.h"
 #include "function_collection.h"
 #include "function_collection_impl.h"
+#include <atomic>
+#include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 
 struct NodeInfo:
@@ -14,6 +18,11 @@ struct NodeInfo:
 	bool isPlaybackEnabled = false;
 	double volumeEnvelope = 1;
 	PlaybackSettings playbackSettings;
+	// installed without locking the network,
+	// read by the audio thread:
+	std::atomic<SampleTap*> tap = nullptr;
+	std::shared_ptr<SampleTap> tapOwner = nullptr;
+	ProfileSlot profile;
 };
 
 
@@ -61,10 +70,22 @@ class SampledFunctionCollectionImpl:
 				const ParameterBindings& parameters
 		) override;
 
-		virtual std::pair<MaybeError, std::vector<Index>> setParameterValuesDeferBufferUpdates(
+		virtual std::optional<ParameterHandle> getParameterHandle(
 				const Index index,
-				const ParameterBindings& parameters
+				const QString& name
+		) const override;
+		virtual C getParameterValue(
+				const Index index,
+				const ParameterHandle handle
+		) const override;
+		virtual void setParameterValueDeferBufferUpdates(
+				const Index index,
+				const ParameterHandle handle,
+				const C& value
 		) override;
+		virtual std::vector<Index> getBufferedEntries(
+				const Index index
+		) const override;
 
 		/***************
 		 * Sampling
@@ -105,6 +126,21 @@ class SampledFunctionCollectionImpl:
 				const Index index,
 				const bool value
 		) override;
+		virtual void setSampleTap(
+				const Index index,
+				std::shared_ptr<SampleTap> tap
+		) override;
+		/* safe while the audio thread renders
+		 * (one caller at a time, holding
+		 * a read lock on the network).
+		 * The previous tap may still be in use
+		 * until the current audio block is done:
+		 */
+		std::shared_ptr<SampleTap> exchangeSampleTap(
+				const Index index,
+				std::shared_ptr<SampleTap> tap
+		);
+		virtual std::vector<NodeStatistics> getNodeStatistics() const override;
 		virtual void valuesToBuffer(
 				std::vector<float>* buffer,
 				const PlaybackPosition position,
@@ -131,17 +167,43 @@ class SampledFunctionCollectionImpl:
 		virtual double getMasterVolume() const override;
 		virtual void setMasterVolume(const double value) override;
 
+		virtual void resetAudioState() override;
+
 		void updateBuffers( const Index startIndex ) override;
+
+		/* run `f` with buffer updates
+		 * deferred: buffers are updated once
+		 * afterwards, from the lowest
+		 * index any change touched:
+		 */
+		void batchUpdates( const std::function<void()>& f );
 	public:
 		::NodeInfo* getNodeInfo( const Index index ) const {
 			return static_cast<::NodeInfo*>(LowLevel::getNodeInfo(index));
 		}
 
 	private:
+		/* what the audio thread needs
+		 * of a playing node:
+		 */
+		struct RenderEntry
+		{
+			Function* function;
+			// ramped per sample:
+			const double* volumeEnvelope;
+			double playbackSpeed;
+			const std::atomic<SampleTap*>* tap;
+			ProfileSlot* profile;
+		};
+
 		float audioFunction(
 				const PlaybackPosition position,
 				const uint samplerate
 		);
+		/* collect valid, enabled nodes,
+		 * after any change to the network:
+		 */
+		void updateRenderList();
 	private:
 		virtual std::shared_ptr<LowLevel::NodeInfo> createNodeInfo(
 				const Index index,
@@ -158,4 +220,12 @@ class SampledFunctionCollectionImpl:
 		double masterEnvelope = 1;
 		double masterVolume = 1;
 		double globalPlaybackSpeed = 1;
+		bool deferBufferUpdates = false;
+		std::optional<Index> deferredBufferUpdates = {};
+		std::vector<RenderEntry> renderList;
+		/* graphs are sampled from the
+		 * graph instances, concurrently
+		 * to the audio. One graph at a time:
+		 */
+		mutable std::mutex graphMutex;
 };
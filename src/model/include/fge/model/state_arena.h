@@ -0,0 +1,61 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+/**
+ * All state variables of a function
+ * in one contiguous, cache line
+ * aligned block of memory.
+ * Variables are laid out once
+ * (`allocate`), then the block is
+ * created (`commit`). Pointers into
+ * the arena stay valid until it
+ * is destroyed.
+ */
+class StateArena
+{
+	public:
+		static constexpr size_t alignment = 64;
+
+		// copy of the values, reusable:
+		using Snapshot = std::vector<C>;
+
+	public:
+		StateArena() = default;
+		~StateArena();
+		StateArena( const StateArena& ) = delete;
+		StateArena& operator=( const StateArena& ) = delete;
+
+		// layout, returns the offset:
+		size_t allocate( const size_t count );
+		void commit();
+
+		C* data( const size_t offset = 0 ) { return memory.get() + offset; }
+		const C* data( const size_t offset = 0 ) const { return memory.get() + offset; }
+		size_t size() const { return count; }
+		// allocated memory:
+		size_t bytes() const;
+
+		// all values to 0:
+		void reset();
+		/* realtime safe if `snapshot` had
+		 * the capacity before:
+		 */
+		void save( Snapshot* snapshot ) const;
+		void restore( const Snapshot& snapshot );
+
+	private:
+		struct Deleter {
+			void operator()( C* ptr ) const {
+				::operator delete( ptr, std::align_val_t( alignment ) );
+			}
+		};
+		std::unique_ptr<C, Deleter> memory = nullptr;
+		size_t count = 0;
+		bool committed = false;
+};
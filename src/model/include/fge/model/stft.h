@@ -0,0 +1,58 @@
+#pragma once
+
+#include "fge/model/fft.h"
+#include <functional>
+#include <vector>
+
+
+/**
+ * Incremental short time fourier transform.
+ * Samples are fed in chunks of any size,
+ * a magnitude spectrum is produced every
+ * `hopSize` samples over the last
+ * `windowSize` samples.
+ * Memory is allocated on construction only.
+ */
+class STFT
+{
+	public:
+		// magnitudes in dB (relative to a
+		// full scale sinusoid), windowSize/2+1 bins:
+		using Frame = std::vector<float>;
+		using FrameCallback = std::function<void(const Frame& frame)>;
+
+		static constexpr float minDB = SpectrumSettings::minDB;
+
+	public:
+		explicit STFT( const SpectrumSettings& settings );
+
+		const SpectrumSettings& getSettings() const;
+		uint binCount() const;
+
+		void process(
+				const float* samples,
+				const size_t count,
+				FrameCallback onFrame
+		);
+		void reset();
+
+	private:
+		void computeFrame();
+
+	private:
+		SpectrumSettings settings;
+		std::vector<float> window;
+		float windowGain;
+		// ring of the last windowSize samples:
+		std::vector<float> history;
+		size_t writePos = 0;
+		size_t filled = 0;
+		size_t sinceLastFrame = 0;
+		std::vector<FFTPlan::value_t> work;
+		Frame frame;
+};
+
+std::vector<float> makeWindow(
+		const WindowType type,
+		const uint size
+);
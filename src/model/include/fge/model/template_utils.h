@@ -1,6 +1,7 @@
 #pragma once
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 // declarations:
 
@@ -38,8 +39,43 @@ auto makeSetter(
 		Args... args
 );
 
+/* the returned callback fulfils the
+ * promise and calls `taskDoneCallback`,
+ * it doesn't refer to the task
+ * (which may be gone by then):
+ */
 template <auto function>
 TaskDoneCallback run(
 		SampledFunctionCollectionImpl* network,
 		SetterTask<function>* setter
 );
+
+/* complete a task superseded by
+ * a later one without running it.
+ * The promise is fulfilled with
+ * `{}` (no error):
+ */
+template <auto function>
+TaskDoneCallback skip(
+		SetterTask<function>* setter
+);
+
+/* true, if `later` makes `earlier`
+ * redundant. Parameter values of
+ * `earlier` are merged into `later`.
+ */
+template <typename Later, typename Earlier>
+bool coalesce(
+		Later* later,
+		Earlier* earlier
+);
+
+/* which of the setters in
+ * `[begin, end)` are redundant
+ * (`Iterator` over task variants):
+ */
+template <typename Iterator>
+std::vector<bool> coalesceSetters(
+		Iterator begin,
+		Iterator end
+);
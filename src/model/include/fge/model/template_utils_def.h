@@ -5,6 +5,8 @@
 #include "sampled_func_collection_impl.h"
 #include <memory>
 #include <type_traits>
+#include <variant>
+#include <vector>
 #include <QDebug>
 #include <unistd.h>
 
@@ -131,6 +133,7 @@ TaskDoneCallback run(
 )
 {
 	using Return = typename FunctionTraits<decltype(function)>::ret_t;
+	auto promise = std::make_shared<std::promise<Return>>( std::move( setter->promise ) );
 	TaskDoneCallback fillPromise;
 	if constexpr ( ! std::is_void<Return>::value ) {
 		auto ret = std::apply(
@@ -140,8 +143,8 @@ TaskDoneCallback run(
 					setter->args
 				)
 		);
-		fillPromise = [setter,ret]{
-			setter->promise.set_value(ret);
+		fillPromise = [promise,ret]{
+			promise->set_value(ret);
 		};
 	}
 	else {
@@ -152,14 +155,103 @@ TaskDoneCallback run(
 					setter->args
 				)
 		);
-		fillPromise = [setter]{
-			setter->promise.set_value();
+		fillPromise = [promise]{
+			promise->set_value();
 		};
 	}
-	return [fillPromise,setter]{
+	return [fillPromise,taskDoneCallback = setter->taskDoneCallback]{
 		fillPromise();
-		setter->taskDoneCallback();
+		taskDoneCallback();
 	};
 }
 
+template <auto function>
+TaskDoneCallback skip(
+		SetterTask<function>* setter
+)
+{
+	using Return = typename FunctionTraits<decltype(function)>::ret_t;
+	auto promise = std::make_shared<std::promise<Return>>( std::move( setter->promise ) );
+	return [promise,taskDoneCallback = setter->taskDoneCallback]{
+		if constexpr ( ! std::is_void<Return>::value ) {
+			promise->set_value( Return{} );
+		}
+		else {
+			promise->set_value();
+		}
+		taskDoneCallback();
+	};
+}
+
+template <typename Later, typename Earlier>
+bool coalesce(
+		Later* later,
+		Earlier* earlier
+) {
+	if constexpr ( !IsSetterTask<Later>::value || !IsSetterTask<Earlier>::value ) {
+		return false;
+	}
+	// indices change:
+	else if constexpr ( std::is_same_v<Later, ResizeTask> || std::is_same_v<Earlier, ResizeTask> ) {
+		return false;
+	}
+	else if constexpr ( std::is_same_v<Later, Earlier> ) {
+		if( std::get<0>(later->args) != std::get<0>(earlier->args) ) {
+			return false;
+		}
+		if constexpr ( std::is_same_v<Later, SetParameterValuesTask> ) {
+			// later values win:
+			std::get<1>(later->args).insert(
+					std::get<1>(earlier->args).begin(),
+					std::get<1>(earlier->args).end()
+			);
+		}
+		return true;
+	}
+	// `set` replaces all parameter values:
+	else if constexpr ( std::is_same_v<Later, SetTask> && std::is_same_v<Earlier, SetParameterValuesTask> ) {
+		return std::get<0>(later->args) == std::get<0>(earlier->args);
+	}
+	return false;
+}
+
+template <typename Iterator>
+std::vector<bool> coalesceSetters(
+		Iterator begin,
+		Iterator end
+) {
+	const auto count = std::distance( begin, end );
+	std::vector<bool> superseded( count, false );
+	for( auto i=0; i<count; i++ ) {
+		for( auto j=i-1; j>=0; j-- ) {
+			auto& later = *(begin + i);
+			auto& earlier = *(begin + j);
+			// don't look past a resize:
+			if( std::holds_alternative<ResizeTask>( earlier ) ) {
+				break;
+			}
+			// nor past a `set` of the same entry,
+			// parameter values refer to its formula:
+			const bool isSetBarrier = std::visit( [](auto& later, auto& earlier) {
+					using Later = std::decay_t<decltype(later)>;
+					using Earlier = std::decay_t<decltype(earlier)>;
+					if constexpr ( std::is_same_v<Later, SetParameterValuesTask> && std::is_same_v<Earlier, SetTask> ) {
+						return std::get<0>(later.args) == std::get<0>(earlier.args);
+					}
+					return false;
+			}, later, earlier );
+			if( isSetBarrier ) {
+				break;
+			}
+			if( superseded[j] ) {
+				continue;
+			}
+			superseded[j] = std::visit( [](auto& later, auto& earlier) {
+					return coalesce( &later, &earlier );
+			}, later, earlier );
+		}
+	}
+	return superseded;
+}
+
 using ModelImpl = ScheduledFunctionCollectionImpl;
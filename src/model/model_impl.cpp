@@ -3,6 +3,8 @@
 #include "include/fge/model/sampled_func_collection_impl.h"
 #include "include/fge/model/template_utils.h"
 #include "include/fge/model/template_utils_def.h"
+#include "fge/shared/rt_safety.h"
+#include "fge/shared/tracing.h"
 #include <cstring>
 #include <ctime>
 #include <memory>
@@ -13,6 +15,7 @@
 #include <ranges>
 #include <algorithm>
 #include <thread>
+#include <utility>
 #ifdef __gnu_linux__
 #include <pthread.h>
 #endif
@@ -34,7 +37,7 @@
 #define LOG_FUNCTION() \
 	{ \
 		const auto location = std::source_location::current(); \
-		qDebug() << QString("%1: %2").arg(double(position) / 44100.0).arg(location.function_name()); \
+		qDebug() << QString("%1: %2").arg(double(currentPosition()) / 44100.0).arg(location.function_name()); \
 	}
 #else
 #define LOG_FUNCTION()
@@ -44,7 +47,7 @@
 #define LOG_FUNCTION_GET() \
 	{ \
 		const auto location = std::source_location::current(); \
-		qDebug() << QString("%1: %2").arg(double(position) / 44100.0).arg(location.function_name()); \
+		qDebug() << QString("%1: %2").arg(double(currentPosition()) / 44100.0).arg(location.function_name()); \
 	}
 #else
 #define LOG_FUNCTION_GET()
@@ -69,6 +72,43 @@ static void postWrite(
 	Ramping::adjustMasterVolume(tasksQueue, network);
 };
 
+/* entry `index` as it will be after
+ * the pending setters have run:
+ */
+template <typename TaskQueue>
+static FunctionInfo scheduledInfo(
+		const TaskQueue& tasksQueue,
+		FunctionInfo info,
+		const uint index
+) {
+	for( const auto& someTask : tasksQueue ) {
+		if( auto task = std::get_if<SetTask>( &someTask ); task && !task->done && std::get<0>(task->args) == index ) {
+			info.formula = std::get<1>(task->args);
+			info.parameters = std::get<2>(task->args);
+			info.stateDescriptions = std::get<3>(task->args);
+		}
+		else if( auto task = std::get_if<SetParameterValuesTask>( &someTask ); task && !task->done && std::get<0>(task->args) == index ) {
+			for( const auto& [name, value] : std::get<1>(task->args) ) {
+				info.parameters[name] = value;
+			}
+		}
+	}
+	return info;
+}
+
+template <typename TaskQueue>
+static uint scheduledSize(
+		const TaskQueue& tasksQueue,
+		uint size
+) {
+	for( const auto& someTask : tasksQueue ) {
+		if( auto task = std::get_if<ResizeTask>( &someTask ); task && !task->done ) {
+			size = std::get<0>(task->args);
+		}
+	}
+	return size;
+}
+
 /************************
  * ScheduledFunctionCollectionImpl:
 ************************/
@@ -76,7 +116,8 @@ static void postWrite(
 ScheduledFunctionCollectionImpl::ScheduledFunctionCollectionImpl(
 		const SamplingSettings& defSamplingSettings
 )
-	: guardedNetwork( std::make_shared<SampledFunctionCollectionImpl>(
+	: clock( "CLOCK" )
+	, guardedNetwork( std::make_shared<SampledFunctionCollectionImpl>(
 				defSamplingSettings
 	), "NETWORK" )
 	, writeTasks( "TASKS" )
@@ -159,6 +200,14 @@ ErrorOrValue<std::vector<std::pair<C,C>>> ScheduledFunctionCollectionImpl::getGr
 	});
 }
 
+std::vector<NodeStatistics> ScheduledFunctionCollectionImpl::getNodeStatistics() const
+{
+	LOG_FUNCTION_GET()
+	return getNetworkConst()->read([](auto& network){
+			return network->getNodeStatistics();
+	});
+}
+
 // sampling for audio:
 
 double ScheduledFunctionCollectionImpl::getPlaybackSpeed() const
@@ -192,13 +241,27 @@ bool ScheduledFunctionCollectionImpl::getIsPlaybackEnabled(
 double ScheduledFunctionCollectionImpl::getPosition() const
 {
 	// LOG_FUNCTION_GET()
-	return this->position;
+	return clock.read().position;
 }
 
 uint ScheduledFunctionCollectionImpl::getSamplerate() const
 {
 	// LOG_FUNCTION_GET()
-	return this->samplerate;
+	return clock.read().samplerate;
+}
+
+uint64_t ScheduledFunctionCollectionImpl::getSilentBlockCount() const
+{
+	return silentBlocks.load( std::memory_order_relaxed );
+}
+
+void ScheduledFunctionCollectionImpl::resetAudioState()
+{
+	// audio instances are only
+	// touched by the audio thread:
+	getNetworkConst()->read([](const auto& network) {
+		network->resetAudioState();
+	});
 }
 
 /************************
@@ -211,8 +274,8 @@ void ScheduledFunctionCollectionImpl::prepareResize()
 	if( !audioSchedulingEnabled ) {
 		return;
 	}
-	writeTasks.write([](auto& tasksQueue) {
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+	writeTasks.write([this](auto& tasksQueue) {
+		fadeOut( tasksQueue );
 	});
 }
 
@@ -223,8 +286,8 @@ void ScheduledFunctionCollectionImpl::prepareSet(const Index index)
 		return;
 	}
 	// ramp down first:
-	writeTasks.write([](auto& tasksQueue) {
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+	writeTasks.write([this](auto& tasksQueue) {
+		fadeOut( tasksQueue );
 	});
 }
 
@@ -234,8 +297,8 @@ void ScheduledFunctionCollectionImpl::prepareSetParameterValues(const Index inde
 	if( !audioSchedulingEnabled ) {
 		return;
 	}
-	writeTasks.write([](auto& tasksQueue) {
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+	writeTasks.write([this](auto& tasksQueue) {
+		fadeOut( tasksQueue );
 	});
 }
 
@@ -250,7 +313,7 @@ void ScheduledFunctionCollectionImpl::prepareSetIsPlaybackEnabled(const Index in
 		if( value ) {
 			Ramping::adjustMasterVolume(tasksQueue, network);
 		}
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+		Ramping::fadeOut( tasksQueue, network );
 	});
 	});
 }
@@ -261,8 +324,8 @@ void ScheduledFunctionCollectionImpl::prepareSetSamplingSettings(const Index ind
 	if( !audioSchedulingEnabled ) {
 		return;
 	}
-	writeTasks.write([](auto& tasksQueue) {
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+	writeTasks.write([this](auto& tasksQueue) {
+		fadeOut( tasksQueue );
 	});
 }
 
@@ -285,26 +348,44 @@ void ScheduledFunctionCollectionImpl::postSetAny()
 }
 
 void ScheduledFunctionCollectionImpl::resize( const uint size )
+{
+	LOG_FUNCTION()
+	std::promise<void> promise;
+	auto future = promise.get_future();
+	resizeAsync( size, [&promise](auto) {
+			promise.set_value();
+	});
+	future.get();
+}
+
+void ScheduledFunctionCollectionImpl::resizeAsync(
+		const uint size,
+		ResizeDone done
+)
 {
 	LOG_FUNCTION()
 	if( !audioSchedulingEnabled ) {
-		getNetwork()->write([size](auto& network){
+		const auto previousSize = getNetwork()->write([size](auto& network){
+			const auto previousSize = network->size();
 			network->resize( size );
+			return previousSize;
 		});
+		done( previousSize );
 		return;
 	}
-	auto future = writeTasks.write([&](auto& tasksQueue) {
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+	writeTasks.write([&](auto& tasksQueue) {
+		const auto previousSize = scheduledSize( tasksQueue, this->size() );
+		fadeOut( tasksQueue );
 		// schedule model change:
-		return makeSetter<::resize>(
+		makeSetter<::resize>(
 				tasksQueue,
-				this->position,
-				[]{},
+				currentPosition(),
+				[done,previousSize]{
+					done( previousSize );
+				},
 				size
 		);
 	});
-	future.get();
-	return;
 }
 
 std::future<MaybeError> toMaybeError( std::future<void>&& f ) {
@@ -318,10 +399,25 @@ MaybeError ScheduledFunctionCollectionImpl::bulkUpdate(
 		const Index index,
 		const Update& update
 )
+{
+	LOG_FUNCTION()
+	std::promise<MaybeError> promise;
+	auto future = promise.get_future();
+	bulkUpdateAsync( index, update, [&promise](auto maybeError) {
+			promise.set_value( maybeError );
+	});
+	return future.get();
+}
+
+void ScheduledFunctionCollectionImpl::bulkUpdateAsync(
+		const Index index,
+		const Update& update,
+		UpdateDone done
+)
 {
 	LOG_FUNCTION()
 	if( !audioSchedulingEnabled ) {
-		return getNetwork()->write([index,&update](auto& network) {
+		done( getNetwork()->write([index,&update](auto& network) {
 			MaybeError ret{};
 			if(
 					update.formula.has_value()
@@ -348,17 +444,50 @@ MaybeError ScheduledFunctionCollectionImpl::bulkUpdate(
 				network->setSamplingSettings(index, update.samplingSettings.value());
 			}
 			return ret;
-		});
+		}) );
+		return;
 	}
 	// audioSchedulingEnabled => update with ramping:
 	update.parameterDescriptions.and_then([&](const auto& descrs) {
-		getNetwork()->read([&](auto& network) {
+		getNetwork()->write([&](auto& network) {
 			network->setParameterDescriptions( index, descrs );
 		});
 		return std::optional<ParameterBindings>{};
 	});
-	auto futures = writeTasks.write([&](auto& tasksQueue)
-			-> std::vector<std::future<MaybeError>>
+	// joins the setters:
+	struct Pending {
+		std::vector<std::future<MaybeError>> futures;
+		uint remaining = 0;
+	};
+	auto pending = std::make_shared<Pending>();
+	// ramp up again, then signal:
+	auto finish = [this,pending,done]{
+		MaybeError ret = {};
+		for( auto& f : pending->futures ) {
+			auto currentRet = f.get();
+			if( currentRet ) {
+				ret = currentRet;
+			}
+		}
+		writeTasks.write([&](auto& tasksQueue) {
+			getNetwork()->read([&tasksQueue](auto& network) {
+				postWrite(
+						tasksQueue,
+						network
+				);
+			});
+		});
+		done( ret );
+	};
+	// setter callbacks are called
+	// by the model worker, one by one:
+	TaskDoneCallback setterDone = [pending,finish]{
+		pending->remaining--;
+		if( pending->remaining == 0 ) {
+			finish();
+		}
+	};
+	writeTasks.write([&](auto& tasksQueue)
 	{
 		// prepare:
 		if(
@@ -366,85 +495,71 @@ MaybeError ScheduledFunctionCollectionImpl::bulkUpdate(
 				|| update.parameters.has_value()
 				|| update.stateDescriptions.has_value()
 		) {
-			Ramping::rampMasterEnv( tasksQueue, 0 );
+			fadeOut( tasksQueue );
 		}
 		if( update.playbackEnabled.has_value() ) {
-			getNetwork()->read([&tasksQueue,index,value = update.playbackEnabled.value()](auto& network) {
+			getNetwork()->read([&tasksQueue,value = update.playbackEnabled.value()](auto& network) {
 				if( value ) {
 					Ramping::adjustMasterVolume(tasksQueue, network);
 				}
-				Ramping::rampMasterEnv( tasksQueue, 0 );
+				Ramping::fadeOut( tasksQueue, network );
 			});
 		}
 		if( update.playbackSettings.has_value() ) {
-			Ramping::rampMasterEnv( tasksQueue, 0 );
+			fadeOut( tasksQueue );
 		}
 		if( update.samplingSettings.has_value() ) {
-			Ramping::rampMasterEnv( tasksQueue, 0 );
+			fadeOut( tasksQueue );
 		}
 		// SET:
-		return [this,&tasksQueue,index,update]()
-			-> std::vector<std::future<MaybeError>>
-		{
-			std::vector<std::future<MaybeError>> ret;
-			if(
-					update.formula.has_value()
-					|| update.parameters.has_value()
-					|| update.stateDescriptions.has_value()
-			) {
-				ret.push_back( std::move( makeSetter<::set>(
-							tasksQueue,
-							this->position,
-							[]{},
-							index,
-							update.formula.value_or( get(index).formula ),
-							update.parameters.value_or( get(index).parameters ),
-							update.stateDescriptions.value_or( get(index).stateDescriptions )
-				) ) );
-			}
-			if( update.playbackSettings.has_value() ) {
-				ret.push_back( toMaybeError( makeSetter<::setPlaybackSettings>(
-						tasksQueue,
-						this->position,
-						[]{},
-						index, update.playbackSettings.value()
-				) ) );
-			}
-			if( update.playbackEnabled.has_value() ) {
-				ret.push_back( toMaybeError( makeSetter<::setIsPlaybackEnabled>(
-						tasksQueue,
-						this->position,
-						[]{},
-						index, update.playbackEnabled.value()
-				) ) );
-			}
-			if( update.samplingSettings.has_value() ) {
-				ret.push_back( toMaybeError( makeSetter<::setSamplingSettings>(
+		auto& futures = pending->futures;
+		if(
+				update.formula.has_value()
+				|| update.parameters.has_value()
+				|| update.stateDescriptions.has_value()
+		) {
+			// unchanged fields as left
+			// by earlier pending updates:
+			const auto info = scheduledInfo( tasksQueue, get(index), index );
+			futures.push_back( makeSetter<::set>(
 						tasksQueue,
-						this->position,
-						[]{},
-						index, update.samplingSettings.value()
-				) ) );
-			}
-			return ret;
-		}();
-	});
-	MaybeError ret = {};
-	for( auto& f : futures ) {
-		auto currentRet = f.get();
-		if( currentRet ) {
-			ret = currentRet;
+						currentPosition(),
+						setterDone,
+						index,
+						update.formula.value_or( info.formula ),
+						update.parameters.value_or( info.parameters ),
+						update.stateDescriptions.value_or( info.stateDescriptions )
+			) );
 		}
-	}
-	writeTasks.write([&](auto& tasksQueue) {
-		getNetwork()->read([&tasksQueue](auto& network) {
-			postWrite(
+		if( update.playbackSettings.has_value() ) {
+			futures.push_back( toMaybeError( makeSetter<::setPlaybackSettings>(
 					tasksQueue,
-					network
-			);
-		});
+					currentPosition(),
+					setterDone,
+					index, update.playbackSettings.value()
+			) ) );
+		}
+		if( update.playbackEnabled.has_value() ) {
+			futures.push_back( toMaybeError( makeSetter<::setIsPlaybackEnabled>(
+					tasksQueue,
+					currentPosition(),
+					setterDone,
+					index, update.playbackEnabled.value()
+			) ) );
+		}
+		if( update.samplingSettings.has_value() ) {
+			futures.push_back( toMaybeError( makeSetter<::setSamplingSettings>(
+					tasksQueue,
+					currentPosition(),
+					setterDone,
+					index, update.samplingSettings.value()
+			) ) );
+		}
+		pending->remaining = futures.size();
 	});
-	return ret;
+	if( pending->futures.empty() ) {
+		finish();
+	}
 }
 
 // Set Entries:
@@ -464,11 +579,11 @@ MaybeError ScheduledFunctionCollectionImpl::set(
 	}
 	auto future = writeTasks.write([&](auto& tasksQueue) {
 		// ramp down first:
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+		fadeOut( tasksQueue );
 		// schedule model change:
 		return makeSetter<::set>(
 					tasksQueue,
-					this->position,
+					currentPosition(),
 					[]{},
 					index, formula, parameters, stateDescriptions
 		);
@@ -518,7 +633,7 @@ MaybeError ScheduledFunctionCollectionImpl::setParameterValues(
 				return future;
 			}
 			// ramp down first:
-			Ramping::rampMasterEnv( tasksQueue, 0 );
+			Ramping::fadeOut( tasksQueue, network );
 			ParameterBindings volumeFadeParameters;
 			for( auto [name, value] : volumeFadeParametersView ) {
 				// qDebug() << "FADE parameter:" << name;
@@ -527,7 +642,7 @@ MaybeError ScheduledFunctionCollectionImpl::setParameterValues(
 			// schedule model change:
 			return makeSetter<::setParameterValues>(
 					tasksQueue,
-					this->position,
+					currentPosition(),
 					[]{},
 					index, volumeFadeParameters
 			);
@@ -549,27 +664,24 @@ ParameterBindings ScheduledFunctionCollectionImpl::scheduleSetParameterValues(
 	return writeTasks.write([&](auto& tasksQueue){
 		// find all parameters which are to be faded by
 		// ramping the parameter
-		ParameterBindings selectedParams = getNetwork()->read([&](auto network) {
-			return parameters
-				| std::ranges::views::filter([&](auto entry) {
-						auto params = network->get(index).parameterDescriptions;
-						if( params.find( entry.first ) == params.end() ) {
-							return false;
-						}
-						return params.at( entry.first ).rampType == FadeType::RampParameter;
-					})
-				| std::ranges::to<ParameterBindings>();
+		ParameterBindings selectedParams;
+		getNetwork()->read([&](auto network) {
+			const auto params = network->get(index).parameterDescriptions;
+			for( auto [parameterName, value] : parameters ) {
+				auto descr = params.find( parameterName );
+				if( descr == params.end() || descr->second.rampType != FadeType::RampParameter ) {
+					continue;
+				}
+				Ramping::rampParameter(
+					tasksQueue,
+					index,
+					parameterName,
+					value.c_.real(),
+					signalizeDone
+				);
+				selectedParams.insert( { parameterName, value } );
+			}
 		});
-		// ramp parameters:
-		for( auto [parameterName, value] : selectedParams ) {
-			Ramping::rampParameter(
-				tasksQueue,
-				index,
-				parameterName,
-				value.c_.real(),
-				signalizeDone
-			);
-		}
 		return selectedParams;
 	});
 }
@@ -597,11 +709,11 @@ void ScheduledFunctionCollectionImpl::setPlaybackSettings(
 	}
 	auto future = writeTasks.write([&](auto& tasksQueue) {
 		// ramp down first:
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+		fadeOut( tasksQueue );
 		// schedule model change:
 		return makeSetter<::setPlaybackSettings>(
 				tasksQueue,
-				this->position,
+				currentPosition(),
 				[]{},
 				index,value
 		);
@@ -628,12 +740,12 @@ void ScheduledFunctionCollectionImpl::setIsPlaybackEnabled(
 			if( value ) {
 				Ramping::adjustMasterVolume(tasksQueue, network);
 			}
-			Ramping::rampMasterEnv( tasksQueue, 0 );
+			Ramping::fadeOut( tasksQueue, network );
 		});
 		// schedule model change:
 		return makeSetter<::setIsPlaybackEnabled>(
 				tasksQueue,
-				this->position,
+				currentPosition(),
 				[]{},
 				index,value
 		);
@@ -655,11 +767,11 @@ void ScheduledFunctionCollectionImpl::setSamplingSettings(
 	}
 	auto future = writeTasks.write([&](auto& tasksQueue) {
 		// ramp down first:
-		Ramping::rampMasterEnv( tasksQueue, 0 );
+		fadeOut( tasksQueue );
 		// schedule model change:
 		return makeSetter<::setSamplingSettings>(
 				tasksQueue,
-				this->position,
+				currentPosition(),
 				[]{},
 				index, value
 		);
@@ -668,6 +780,31 @@ void ScheduledFunctionCollectionImpl::setSamplingSettings(
 	return;
 }
 
+void ScheduledFunctionCollectionImpl::setSampleTap(
+		const Index index,
+		std::shared_ptr<SampleTap> tap
+)
+{
+	LOG_FUNCTION()
+	// no ramping necessary,
+	// the tap does not change the output.
+	// the audio thread may keep rendering:
+	auto previous = getNetwork()->read([index,tap](const auto& network) {
+		return network->exchangeSampleTap( index, tap );
+	});
+	if( !previous ) {
+		return;
+	}
+	// the current audio block might still
+	// write to it, release it afterwards
+	// (on the model worker, see `modelWorkerLoop`):
+	writeTasks.write([previous](auto& tasksQueue) {
+		tasksQueue.push_back(SignalReturnTask{
+				.signalDone = [previous]{}
+		});
+	});
+}
+
 // Control Scheduling:
 
 void ScheduledFunctionCollectionImpl::valuesToBuffer(
@@ -676,12 +813,14 @@ void ScheduledFunctionCollectionImpl::valuesToBuffer(
 		const unsigned int samplerate
 )
 {
+	FGE_RT_SCOPE( "valuesToBuffer" );
 	if( expensiveTaskRunning ) {
+		silentBlocks.fetch_add( 1, std::memory_order_relaxed );
 		std::ranges::fill(buffer->begin(),buffer->end(), 0);
 		return;
 	}
 	writeTasks.write([this,buffer,position,samplerate](auto& tasksQueue) {
-	getNetworkConst()->read([this,buffer,position,samplerate,&tasksQueue](const auto& network) {
+	getNetworkConst()->read([buffer,position,samplerate,&tasksQueue](const auto& network) {
 		network->valuesToBuffer(
 				buffer,
 				position, samplerate,
@@ -707,44 +846,53 @@ bool ScheduledFunctionCollectionImpl::getAudioSchedulingEnabled() const
 void ScheduledFunctionCollectionImpl::setAudioSchedulingEnabled(
 		const bool value
 )
+{
+	LOG_FUNCTION()
+	std::promise<void> promise;
+	auto future = promise.get_future();
+	setAudioSchedulingEnabledAsync( value, [&promise]{
+			promise.set_value();
+	});
+	future.get();
+}
+
+void ScheduledFunctionCollectionImpl::setAudioSchedulingEnabledAsync(
+		const bool value,
+		std::function<void()> done
+)
 {
 	LOG_FUNCTION()
 	if( value == audioSchedulingEnabled ) {
+		done();
 		return;
 	}
 	// switch on:
 	if( value == true ) {
 		audioSchedulingEnabled = value;
-		auto returnSignal = writeTasks.write([this](auto& tasksQueue) {
+		writeTasks.write([this,done](auto& tasksQueue) {
 			Ramping::rampMasterEnv( tasksQueue, 1 );
 			getNetwork()->read([&tasksQueue](auto& network) {
 				Ramping::adjustMasterVolume(tasksQueue, network);
 			});
-			return [&](){
-				auto task = SignalReturnTask{};
-				auto returnSignal = task.promise.get_future();
-				tasksQueue.push_back(std::move(task));
-				return returnSignal;
-			}();
+			tasksQueue.push_back(SignalReturnTask{
+					.signalDone = done
+			});
 		});
-		returnSignal.get();
 		return;
 	}
 	// switch off:
 	else {
 		// assert( masterVolumeEnv >= 0.99 );
-		auto returnSignal = writeTasks.write([](auto &tasksQueue) {
+		writeTasks.write([this,value,done](auto &tasksQueue) {
 			Ramping::rampMasterEnv( tasksQueue, 0 );
-			return [&](){
-				auto task = SignalReturnTask{};
-				auto returnSignal = task.promise.get_future();
-				tasksQueue.push_back(std::move(task));
-				return returnSignal;
-			}();
+			tasksQueue.push_back(SignalReturnTask{
+					.signalDone = [this,value,done]{
+						// assert( masterVolumeEnv < 0.01 );
+						audioSchedulingEnabled = value;
+						done();
+					}
+			});
 		});
-		returnSignal.get();
-		// assert( masterVolumeEnv < 0.01 );
-		audioSchedulingEnabled = value;
 		return;
 	}
 }
@@ -754,8 +902,11 @@ void ScheduledFunctionCollectionImpl::betweenAudio(
 		const uint samplerate
 )
 {
-	this->position = position;
-	this->samplerate = samplerate;
+	FGE_RT_SCOPE( "betweenAudio" );
+	clock.write([position,samplerate](auto& clock) {
+			clock.position = position;
+			clock.samplerate = samplerate;
+	});
 	writeTasks.try_write([&](auto& tasksQueue) -> void {
 		// 1. 
 		if( !tasksQueue.empty() ) {
@@ -773,9 +924,12 @@ void ScheduledFunctionCollectionImpl::betweenAudio(
 					}
 					else if constexpr ( std::is_same_v<Task,SignalReturnTask> ) {
 						if( !task.done ) {
-							task.promise.set_value();
+							// the callback might
+							// allocate or lock:
+							std::unique_lock lock( writeTasksSignal.lock );
+							writeTasksSignal.pendingTask = true;
+							writeTasksSignal.condition_var.notify_one();
 						}
-						task.done = true;
 					}
 			}, someTask );
 		}
@@ -817,6 +971,11 @@ void ScheduledFunctionCollectionImpl::betweenAudio(
 		}
 		#endif
 
+		// queueing follow-up setters and removing
+		// finished tasks (de)allocates queue nodes.
+		// Knowingly not realtime safe until the
+		// queue is preallocated:
+		rt_safety::Allow allowQueueUpdates;
 		auto finishedRamps = tasksQueue
 				| std::views::filter([](auto& someTask){
 					auto task = std::get_if<RampParameterTask>(&someTask);
@@ -828,12 +987,12 @@ void ScheduledFunctionCollectionImpl::betweenAudio(
 				| std::ranges::to<std::vector<RampParameterTask*>>()
 		;
 		for( auto task : finishedRamps ) {
-			if( !task->delayedUpdates.empty() ) {
+			if( task->delayedUpdates && !task->delayedUpdates->empty() ) {
 				Ramping::rampMasterEnv( tasksQueue, 0 );
 			}
 			makeSetter<::updateBuffers>(
 					tasksQueue,
-					this->position,
+					currentPosition(),
 					[ signalizeDone = task->signalizeDone
 					, index = task->index
 					, name = task->parameterName
@@ -885,6 +1044,7 @@ void ScheduledFunctionCollectionImpl::betweenAudio(
 void ScheduledFunctionCollectionImpl::modelWorkerLoop()
 {
 	qDebug() << "MODEL WORKER THREAD: start";
+	FGE_TRACE_THREAD( "MODEL WORKER" );
 	while(true) {
 		{
 			std::unique_lock lock( writeTasksSignal.lock );
@@ -902,38 +1062,81 @@ void ScheduledFunctionCollectionImpl::modelWorkerLoop()
 			break;
 		}
 		qDebug() << "MODEL WORKER THREAD: woke up";
-		TaskDoneCallback taskDoneCallback = writeTasks.write([&](auto& tasksQueue) {
+		TaskDoneCallback taskDoneCallback = writeTasks.write([&](auto& tasksQueue) -> TaskDoneCallback {
 			assert( !tasksQueue.empty() );
-			auto& someTask = tasksQueue.front();
-			return std::visit([&](auto& task)
-					-> TaskDoneCallback
-			{
-					using Task = std::decay_t<decltype(task)>;
-					assert( IsSetterTask<Task>::value );
-					if constexpr ( IsSetterTask<Task>::value ) {
-						assert( !task.done );
-						expensiveTaskRunning = true;
-						auto ret = getNetwork()->write([&task](auto network) {
-							return run(network.get(), &task);
-						});
-						expensiveTaskRunning = false;
-						#ifdef LOG_MODEL
-						qDebug() << QString("%1: executing '%2")
-							.arg( double(position) / double(samplerate) )
-							.arg( functionName(task) )
-						;
-						#endif
-						task.done = true;
-						return ret;
+			// all tasks before are done:
+			if( auto task = std::get_if<SignalReturnTask>( &tasksQueue.front() ) ) {
+				if( task->done ) {
+					return []{};
+				}
+				task->done = true;
+				// moved out: the callback and its captures
+				// are destroyed here instead of on the
+				// audio thread erasing the task:
+				return std::exchange( task->signalDone, nullptr );
+			}
+			// all setters at the front
+			// are executed as one batch:
+			const auto batchEnd = std::ranges::find_if( tasksQueue, [](auto& someTask) {
+					return std::visit( [](auto& task) {
+							using Task = std::decay_t<decltype(task)>;
+							return !IsSetterTask<Task>::value;
+					}, someTask );
+			});
+			const auto superseded = coalesceSetters( tasksQueue.begin(), batchEnd );
+			std::vector<TaskDoneCallback> callbacks;
+			expensiveTaskRunning = true;
+			getNetwork()->write([&](auto network) {
+				network->batchUpdates([&]{
+					uint i = 0;
+					for( auto it = tasksQueue.begin(); it != batchEnd; it++, i++ ) {
+						std::visit([&](auto& task) {
+								using Task = std::decay_t<decltype(task)>;
+								if constexpr ( IsSetterTask<Task>::value ) {
+									if( task.done ) {
+										return;
+									}
+									if( superseded[i] ) {
+										callbacks.push_back( skip( &task ) );
+									}
+									else {
+										FGE_TRACE_SCOPE( "task", functionName(task) );
+										callbacks.push_back( run( network.get(), &task ) );
+									}
+									#ifdef LOG_MODEL
+									qDebug() << QString("%1: %2 '%3")
+										.arg( getPosition() / double(getSamplerate()) )
+										.arg( superseded[i] ? "skipping" : "executing" )
+										.arg( functionName(task) )
+									;
+									#endif
+									task.done = true;
+								}
+						}, *it );
 					}
-					return {};
-			}, someTask );
+				});
+			});
+			expensiveTaskRunning = false;
+			return [callbacks]{
+				for( const auto& callback : callbacks ) {
+					callback();
+				}
+			};
 		});
 		taskDoneCallback();
 		writeTasksSignal.pendingTask = false;
 	};
 }
 
+void ScheduledFunctionCollectionImpl::fadeOut( std::deque<WriteTask>& tasksQueue )
+{
+	// the audio thread only moves the
+	// envelope while holding `writeTasks`:
+	getNetworkConst()->read([&tasksQueue](const auto& network) {
+		Ramping::fadeOut( tasksQueue, network );
+	});
+}
+
 /************************
  * Ramping
 ************************/
@@ -947,6 +1150,28 @@ void Ramping::rampMasterEnv(
 	tasksQueue.push_back(std::move(task));
 }
 
+template <typename TaskQueue>
+void Ramping::fadeOut(
+		TaskQueue& tasksQueue,
+		const std::shared_ptr<SampledFunctionCollectionImpl> network
+) {
+	// the latest ramp wins:
+	auto envRamps = tasksQueue
+		| std::views::reverse
+		| std::views::filter([](auto& someTask) {
+				return std::holds_alternative<RampMasterEnvTask>(someTask);
+		})
+	;
+	const double target =
+		!envRamps.empty()
+		? std::get<RampMasterEnvTask>( envRamps.front() ).dst
+		: network->getMasterEnvelope();
+	if( target == 0 ) {
+		return;
+	}
+	rampMasterEnv( tasksQueue, 0 );
+}
+
 template <typename TaskQueue>
 void Ramping::rampEntry(
 		TaskQueue& tasksQueue,
@@ -1003,6 +1228,7 @@ void Ramping::updateRamps(
 		const PlaybackPosition position,
 		const uint samplerate
 ) {
+	FGE_RT_SCOPE( "updateRamps" );
 	// all recent entries which are ramps:
 	auto rampView  = (
 		tasksQueue
@@ -1071,48 +1297,67 @@ void Ramping::updateRamps(
 				position, samplerate
 		);
 	}
-	// RampParameterTask:
-	for( uint index=0; index<network->size(); index++ )
-	{
-		for( auto [parameterName,_] : network->get(index).parameters ) {
-			auto view = rampView
-				| std::views::filter([index,parameterName](auto& someTask){
-					auto task = std::get_if<RampParameterTask>(&someTask);
-					return
-						task
-						&& (task->index == index)
-						&& (task->parameterName == parameterName)
-						&& !task->done;
-				})
-				| std::views::transform([](auto& task){
-					return &std::get<RampParameterTask>( task );
-				})
-			;
-			updateRamp<RampParameterTask>(
-					view,
-					[network](auto task) -> double {
-						return network->get(task->index).parameters.at(
-								task->parameterName
-						).c_.real();
-					},
-					[network,index](auto task, const double value) {
-						task->delayedUpdates =
-							network->setParameterValuesDeferBufferUpdates(
-									task->index,
-									{ { task->parameterName, { C(value,0) } } }
-							).second;
-					},
-					position, samplerate
-			);
+	// RampParameterTask, per parameter:
+	for( auto& someTask : rampView ) {
+		auto current = std::get_if<RampParameterTask>(&someTask);
+		if( !current || current->done ) {
+			continue;
+		}
+		// by handle from here on, the
+		// parameter might be gone by now:
+		if( !current->pos ) {
+			const auto handle = network->getParameterHandle( current->index, current->parameterName );
+			if( !handle ) {
+				current->done = true;
+				continue;
+			}
+			current->parameter = handle.value();
 		}
+		auto view = rampView
+			| std::views::filter([current](auto& someTask){
+				auto task = std::get_if<RampParameterTask>(&someTask);
+				return
+					task
+					&& (task->index == current->index)
+					&& (task->parameterName == current->parameterName)
+					&& !task->done;
+			})
+			| std::views::transform([](auto& task){
+				return &std::get<RampParameterTask>( task );
+			})
+		;
+		// superseded ramps of the same parameter:
+		for( auto task : view ) {
+			task->parameter = current->parameter;
+		}
+		updateRamp<RampParameterTask>(
+				view,
+				[network](auto task) -> double {
+					return network->getParameterValue(
+							task->index,
+							task->parameter
+					).c_.real();
+				},
+				[network](auto task, const double value) {
+					network->setParameterValueDeferBufferUpdates(
+							task->index,
+							task->parameter,
+							C(value,0)
+					);
+					if( !task->delayedUpdates ) {
+						task->delayedUpdates = network->getBufferedEntries( task->index );
+					}
+				},
+				position, samplerate
+		);
 	}
 }
 
-template <typename Task, typename View>
+template <typename Task, typename View, typename GetValue, typename SetValue>
 void Ramping::updateRamp(
 		View view,
-		std::function<double(const Task* task)> getValue,
-		std::function<void(Task* task,const double)> setValue,
+		GetValue getValue,
+		SetValue setValue,
 		const PlaybackPosition position,
 		const uint samplerate
 ) {
@@ -1152,6 +1397,9 @@ void Ramping::updateRamp(
 				);
 			}
 			else {
+				// land exactly on the target,
+				// e.g. an envelope at 0:
+				setValue( task, task->dst );
 				task->done = true;
 			}
 		}
@@ -0,0 +1,135 @@
+#include "fge/model/oscillators.h"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+
+namespace intern {
+
+	using complex = std::complex<T>;
+
+	/* plain multiplication,
+	 * without the inf/nan handling of
+	 * `std::complex`, which defeats
+	 * vectorization:
+	 */
+	inline complex mul( const complex& a, const complex& b )
+	{
+		return complex(
+				a.real() * b.real() - a.imag() * b.imag(),
+				a.real() * b.imag() + a.imag() * b.real()
+		);
+	}
+
+} // namespace intern
+
+std::complex<T> harmonicSum(
+		const C* coeffs,
+		const size_t size,
+		const std::complex<T>& z
+)
+{
+	using intern::complex;
+	using intern::mul;
+	if( size == 0 ) {
+		return 0;
+	}
+	/* independent Horner schemes in w = z^chains,
+	 * chain j sums the partials k = j+1 (mod chains):
+	 */
+	constexpr size_t chains = 4;
+	const auto z2 = mul( z, z );
+	const auto w = mul( z2, z2 );
+	std::array<complex, chains> acc = {};
+	const size_t rows = (size + chains - 1) / chains;
+	// the last row may be incomplete:
+	for( size_t j=0; j<chains; j++ ) {
+		const size_t k = (rows-1) * chains + j;
+		acc[j] = (k < size) ? coeffs[k].c_ : complex(0);
+	}
+	for( size_t row = rows-1; row-- > 0; ) {
+		const C* current = coeffs + row * chains;
+		for( size_t j=0; j<chains; j++ ) {
+			acc[j] = mul( acc[j], w ) + current[j].c_;
+		}
+	}
+	complex ret = 0;
+	complex zj = z;
+	for( size_t j=0; j<chains; j++ ) {
+		ret += mul( zj, acc[j] );
+		zj = mul( zj, z );
+	}
+	return ret;
+}
+
+/*******************
+ * HarmonicsFunction
+ ******************/
+
+HarmonicsFunction::HarmonicsFunction()
+	: exprtk::igeneric_function<C>("TV")
+{}
+
+C HarmonicsFunction::operator()(parameter_list_t parameters)
+{
+	using generic_type = exprtk::igeneric_function<C>::generic_type;
+	using scalar_t = generic_type::scalar_view;
+	using vector_t = generic_type::vector_view;
+	scalar_t phase(parameters[0]);
+	vector_t amps(parameters[1]);
+	// only the fractional part matters,
+	// keeps the argument small:
+	const T cycles = phase().c_.real();
+	const auto z = std::polar( T(1), 2 * std::numbers::pi * (cycles - std::floor( cycles )) );
+	return C( harmonicSum( amps.begin(), amps.size(), z ) );
+}
+
+/*******************
+ * PhasorFunction
+ ******************/
+
+PhasorFunction::PhasorFunction()
+	: exprtk::igeneric_function<C>("TV")
+{}
+
+C PhasorFunction::operator()(parameter_list_t parameters)
+{
+	using generic_type = exprtk::igeneric_function<C>::generic_type;
+	using scalar_t = generic_type::scalar_view;
+	using vector_t = generic_type::vector_view;
+	scalar_t angleParam(parameters[0]);
+	vector_t state(parameters[1]);
+	const T angle = angleParam().c_.real();
+	if( state.size() < phasorStateSize ) {
+		return C( std::polar( T(1), angle ) );
+	}
+	/* s[0]: calls since exact (0: none yet),
+	 * s[1]: previous angle, step of the rotation,
+	 * s[2]: rotation by the step,
+	 * s[3]: previous value
+	 */
+	const T count = state[0].c_.real();
+	const T step = angle - state[1].c_.real();
+	T rotationStep = state[1].c_.imag();
+	// steps from equidistant x
+	// differ by rounding errors:
+	const T tolerance = 8 * std::numeric_limits<T>::epsilon() * (std::abs( angle ) + 1);
+	const bool sameStep = count > 0 && std::abs( step - rotationStep ) <= tolerance;
+	std::complex<T> value;
+	if( sameStep && count < phasorRenormalize ) {
+		value = intern::mul( state[3].c_, state[2].c_ );
+		state[0] = C( count + 1, 0 );
+	}
+	else {
+		value = std::polar( T(1), angle );
+		state[0] = C( 1, 0 );
+		if( !sameStep ) {
+			rotationStep = step;
+			state[2] = C( std::polar( T(1), step ) );
+		}
+	}
+	state[1] = C( angle, rotationStep );
+	state[3] = C( value );
+	return C( value );
+}
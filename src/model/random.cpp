@@ -0,0 +1,153 @@
+#include "fge/model/random.h"
+#include <cmath>
+#include <numbers>
+
+
+namespace intern {
+
+	inline uint64_t rotl( const uint64_t x, const int k )
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	// to expand a seed into the state:
+	inline uint64_t splitmix64( uint64_t* x )
+	{
+		uint64_t z = (*x += 0x9e3779b97f4a7c15);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+} // namespace intern
+
+/*******************
+ * Random
+ ******************/
+
+Random::Random( const uint64_t seed )
+{
+	this->seed( seed );
+}
+
+void Random::seed( const uint64_t seed )
+{
+	uint64_t x = seed;
+	for( auto& value : state ) {
+		value = intern::splitmix64( &x );
+	}
+	spareNormal = {};
+}
+
+uint64_t Random::next()
+{
+	const uint64_t ret = state[0] + state[3];
+	const uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = intern::rotl( state[3], 45 );
+	return ret;
+}
+
+T Random::uniform()
+{
+	// upper 53 bits (the lowest ones are weak):
+	return T( next() >> 11 ) * 0x1.0p-53;
+}
+
+T Random::normal()
+{
+	if( spareNormal ) {
+		const auto ret = spareNormal.value();
+		spareNormal = {};
+		return ret;
+	}
+	// Box-Muller, avoiding log(0):
+	const T radius = std::sqrt( -2 * std::log( 1 - uniform() ) );
+	const T angle = 2 * std::numbers::pi * uniform();
+	spareNormal = radius * std::sin( angle );
+	return radius * std::cos( angle );
+}
+
+void Random::fillUniform( C* values, const size_t count )
+{
+	for( size_t i=0; i<count; i++ ) {
+		values[i] = C( uniform(), 0 );
+	}
+}
+
+void Random::fillNormal( C* values, const size_t count )
+{
+	for( size_t i=0; i<count; i++ ) {
+		values[i] = C( normal(), 0 );
+	}
+}
+
+/*******************
+ * exprtk builtins
+ ******************/
+
+RandomFunction::RandomFunction( Random* random )
+	: exprtk::ifunction<C>(0)
+	, random( random )
+{}
+
+C RandomFunction::operator()()
+{
+	return C( random->uniform(), 0 );
+}
+
+NormalRandomFunction::NormalRandomFunction( Random* random )
+	: exprtk::ifunction<C>(0)
+	, random( random )
+{}
+
+C NormalRandomFunction::operator()()
+{
+	return C( random->normal(), 0 );
+}
+
+template <bool normal>
+RandomFillFunction<normal>::RandomFillFunction( Random* random )
+	: exprtk::igeneric_function<C>("V")
+	, random( random )
+{}
+
+template <bool normal>
+C RandomFillFunction<normal>::operator()(parameter_list_t parameters)
+{
+	using generic_type = exprtk::igeneric_function<C>::generic_type;
+	using vector_t = generic_type::vector_view;
+	vector_t values(parameters[0]);
+	if constexpr( normal ) {
+		random->fillNormal( values.begin(), values.size() );
+	}
+	else {
+		random->fillUniform( values.begin(), values.size() );
+	}
+	return C(0,0);
+}
+
+template struct RandomFillFunction<false>;
+template struct RandomFillFunction<true>;
+
+uint64_t seedFromString( const QString& str )
+{
+	// FNV-1a:
+	uint64_t hash = 0xcbf29ce484222325;
+	const auto bytes = str.toUtf8();
+	for( qsizetype i=0; i<bytes.size(); i++ ) {
+		hash ^= uint8_t( bytes.constData()[i] );
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+uint64_t mixSeed( const uint64_t seed, const uint64_t other )
+{
+	uint64_t x = seed ^ intern::rotl( other, 32 );
+	return intern::splitmix64( &x );
+}
@@ -5,6 +5,8 @@
 #include "include/fge/model/function_collection_impl.h"
 #include "include/fge/model/sampled_func_collection.h"
 #include "include/fge/model/function_sampling_utils.h"
+#include "fge/shared/tracing.h"
+#include <algorithm>
 #include <memory>
 #include <strings.h>
 #include <QDebug>
@@ -111,31 +113,62 @@ MaybeError SampledFunctionCollectionImpl::setParameterValues(
 )
 {
 	LOG_FUNCTION()
-	auto ret = setParameterValuesDeferBufferUpdates( index, parameters ).first;
+	auto ret = LowLevel::setParameterValues( index, parameters );
 	updateBuffers(index);
 	return ret;
 }
 
-std::pair<MaybeError, std::vector<SampledFunctionCollectionImpl::Index>> SampledFunctionCollectionImpl::setParameterValuesDeferBufferUpdates(
+std::optional<ParameterHandle> SampledFunctionCollectionImpl::getParameterHandle(
 		const Index index,
-		const ParameterBindings& parameters
+		const QString& name
+) const
+{
+	auto function = LowLevel::getFunctionRaw( index );
+	if( !function ) {
+		return {};
+	}
+	return function->getParameterHandle( name );
+}
+
+C SampledFunctionCollectionImpl::getParameterValue(
+		const Index index,
+		const ParameterHandle handle
+) const
+{
+	auto function = LowLevel::getFunctionRaw( index );
+	if( !function ) {
+		return C(0,0);
+	}
+	return function->getParameter( handle );
+}
+
+void SampledFunctionCollectionImpl::setParameterValueDeferBufferUpdates(
+		const Index index,
+		const ParameterHandle handle,
+		const C& value
 )
 {
-	LOG_FUNCTION()
-	auto ret = LowLevel::setParameterValues( index, parameters );
+	auto function = LowLevel::getFunctionRaw( index );
+	if( !function ) {
+		return;
+	}
+	// called per sample while ramping,
+	// resetting the state would restart
+	// random sequences, filters, ...:
+	function->setParameter( handle, value );
+}
+
+std::vector<SampledFunctionCollectionImpl::Index> SampledFunctionCollectionImpl::getBufferedEntries(
+		const Index index
+) const
+{
 	std::vector<Index> buffered;
 	for(uint i=index; i<size(); i++) {
-		std::shared_ptr<Function> maybeFunction = nullptr;
-		auto functionOrError = LowLevel::getFunction(i);
-		if( functionOrError ) {
-			maybeFunction = functionOrError.value();
-		}
-		const auto& samplingSettings = getSamplingSettings(i);
-		if( maybeFunction && isBufferable(samplingSettings) ) {
+		if( LowLevel::getFunctionRaw(i) && isBufferable( getSamplingSettings(i) ) ) {
 			buffered.push_back( i );
 		}
 	}
-	return { ret, buffered };
+	return buffered;
 }
 
 
@@ -162,6 +195,7 @@ void SampledFunctionCollectionImpl::setSamplingSettings(
 	functionOrError.transform([this,index](auto function) {
 		updateBuffers(index);
 	});
+	updateRenderList();
 }
 
 // sampling for visual representation:
@@ -178,19 +212,32 @@ ErrorOrValue<std::vector<std::pair<C,C>>> SampledFunctionCollectionImpl::getGrap
 	}
 	else
 	{
-		auto func = errorOrFunction.value();
+		auto func = LowLevel::getGraphFunctionRaw( index );
 		auto
 			xMin = range.first,
 			xMax = range.second
 		;
+		FGE_TRACE_SCOPE( "graph", "getGraph" );
+		profiler::ContextGuard profileContext( profiler::Context::Graph );
+		std::scoped_lock lock( graphMutex );
+		// every graph starts from the initial state:
+		for( Index i=0; i<=index; i++ ) {
+			if( auto function = LowLevel::getGraphFunctionRaw(i) ) {
+				function->resetState();
+			}
+		}
 		std::vector<std::pair<C,C>> graph;
 		for( unsigned int i=0; i<resolution; i++ ) {
 			auto x = C( xMin + (T(i) / (resolution-1))*(xMax - xMin), 0);
+			ProfileScope scope( func->getProfileSlot() );
 			graph.push_back({
 					x,
 					func->get(x)
 			});
 		}
+		for( Index i=0; i<=index; i++ ) {
+			getNodeInfo(i)->profile.publish( profiler::Context::Graph, resolution );
+		}
 		return graph;
 	}
 }
@@ -224,6 +271,7 @@ void SampledFunctionCollectionImpl::setPlaybackSettings(
 {
 	LOG_FUNCTION()
 	getNodeInfo(index)->playbackSettings = value;
+	updateRenderList();
 }
 
 bool SampledFunctionCollectionImpl::getIsPlaybackEnabled(
@@ -241,6 +289,41 @@ void SampledFunctionCollectionImpl::setIsPlaybackEnabled(
 {
 	LOG_FUNCTION()
 	getNodeInfo(index)->isPlaybackEnabled = value;
+	updateRenderList();
+}
+
+void SampledFunctionCollectionImpl::setSampleTap(
+		const Index index,
+		std::shared_ptr<SampleTap> tap
+)
+{
+	exchangeSampleTap( index, tap );
+}
+
+std::shared_ptr<SampleTap> SampledFunctionCollectionImpl::exchangeSampleTap(
+		const Index index,
+		std::shared_ptr<SampleTap> tap
+)
+{
+	auto info = getNodeInfo(index);
+	info->tap.store( tap.get(), std::memory_order_release );
+	std::swap( info->tapOwner, tap );
+	return tap;
+}
+
+std::vector<NodeStatistics> SampledFunctionCollectionImpl::getNodeStatistics() const
+{
+	std::vector<NodeStatistics> ret;
+	for( Index i=0; i<size(); i++ ) {
+		const auto& profile = getNodeInfoConst(i)->profile;
+		const auto function = LowLevel::getFunctionRaw(i);
+		ret.push_back({
+				.audio = profile.read( profiler::Context::Audio ),
+				.graph = profile.read( profiler::Context::Graph ),
+				.stateBytes = function ? function->getStateBytes() : 0
+		});
+	}
+	return ret;
 }
 
 void SampledFunctionCollectionImpl::valuesToBuffer(
@@ -250,6 +333,7 @@ void SampledFunctionCollectionImpl::valuesToBuffer(
 		AudioCallback callback
 )
 {
+	profiler::ContextGuard profileContext( profiler::Context::Audio );
 	for(
 			PlaybackPosition pos=0;
 			pos<buffer->size();
@@ -259,6 +343,9 @@ void SampledFunctionCollectionImpl::valuesToBuffer(
 			audioFunction(position+pos, samplerate);
 		callback( position+pos, samplerate );
 	}
+	for( Index i=0; i<size(); i++ ) {
+		getNodeInfo(i)->profile.publish( profiler::Context::Audio, buffer->size() );
+	}
 }
 
 double SampledFunctionCollectionImpl::getMasterEnvelope() const 
@@ -281,8 +368,21 @@ void SampledFunctionCollectionImpl::setMasterVolume(const double value)
 	masterVolume = value;
 }
 
+void SampledFunctionCollectionImpl::resetAudioState()
+{
+	for( Index i=0; i<size(); i++ ) {
+		if( auto function = LowLevel::getFunctionRaw( i ) ) {
+			function->resetState();
+		}
+	}
+}
+
 void SampledFunctionCollectionImpl::updateBuffers( const Index startIndex )
 {
+	if( deferBufferUpdates ) {
+		deferredBufferUpdates = std::min( deferredBufferUpdates.value_or( startIndex ), startIndex );
+		return;
+	}
 	for(uint index=startIndex; index<size(); index++) {
 		std::shared_ptr<Function> maybeFunction = nullptr;
 		auto functionOrError = LowLevel::getFunction(index);
@@ -292,6 +392,19 @@ void SampledFunctionCollectionImpl::updateBuffers( const Index startIndex )
 		}
 		updateBuffer( index, maybeFunction );
 	}
+	updateRenderList();
+}
+
+void SampledFunctionCollectionImpl::batchUpdates( const std::function<void()>& f )
+{
+	deferBufferUpdates = true;
+	f();
+	deferBufferUpdates = false;
+	if( deferredBufferUpdates ) {
+		const auto startIndex = deferredBufferUpdates.value();
+		deferredBufferUpdates = {};
+		updateBuffers( startIndex );
+	}
 }
 
 // private:
@@ -303,23 +416,39 @@ float SampledFunctionCollectionImpl::audioFunction(
 {
 	double ret = 0;
 	C time = C(T(position) / T(samplerate), 0);
+	for( const auto& entry : renderList ) {
+		const double value = [&]{
+			ProfileScope scope( entry.profile );
+			return entry.function->get(
+					time * globalPlaybackSpeed * entry.playbackSpeed
+			).c_.real();
+		}() * (*entry.volumeEnvelope);
+		if( auto tap = entry.tap->load( std::memory_order_acquire ) ) {
+			tap->push( value );
+		}
+		ret += value;
+	}
+	ret *= (masterEnvelope * masterVolume);
+	return std::clamp( ret, -1.0, +1.0 );
+}
+
+void SampledFunctionCollectionImpl::updateRenderList()
+{
+	renderList.clear();
 	for( Index i=0; i<size(); i++ ) {
 		auto functionOrError = LowLevel::getFunction(i);
-		auto isPlaybackEnabled = getNodeInfo(i)->isPlaybackEnabled;
-		if( !functionOrError || !isPlaybackEnabled )
+		auto info = getNodeInfo(i);
+		if( !functionOrError || !info->isPlaybackEnabled ) {
 			continue;
-		auto function = functionOrError.value();
-		double volEnv = getNodeInfoConst(i)->volumeEnvelope;
-		const auto& playbackSettings = getNodeInfoConst(i)->playbackSettings;
-		ret += (
-				function->get(
-					time * globalPlaybackSpeed * playbackSettings.playbackSpeed
-				).c_.real()
-				* volEnv
-		);
+		}
+		renderList.push_back({
+				.function = functionOrError.value().get(),
+				.volumeEnvelope = &info->volumeEnvelope,
+				.playbackSpeed = info->playbackSettings.playbackSpeed,
+				.tap = &info->tap,
+				.profile = &info->profile
+		});
 	}
-	ret *= (masterEnvelope * masterVolume);
-	return std::clamp( ret, -1.0, +1.0 );
 }
 
 std::shared_ptr<SampledFunctionCollectionImpl::LowLevel::NodeInfo> SampledFunctionCollectionImpl::createNodeInfo(
@@ -338,6 +467,15 @@ void SampledFunctionCollectionImpl::updateBuffer(
 )
 {
 	if( maybeFunction ) {
+		FGE_TRACE_SCOPE( "model", "updateBuffer" );
+		auto graphFunction = LowLevel::getGraphFunctionRaw( index );
+		// catch up with ramped parameters:
+		for( const auto& [name, value] : maybeFunction->getParameters() ) {
+			graphFunction->setParameter( name, value );
+		}
+		maybeFunction->setProfileSlot( &getNodeInfo(index)->profile );
+		graphFunction->setProfileSlot( &getNodeInfo(index)->profile );
 		maybeFunction->update();
+		graphFunction->update();
 	}
 }
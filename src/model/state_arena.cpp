@@ -0,0 +1,56 @@
+#include "fge/model/state_arena.h"
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+
+static_assert( std::is_trivially_destructible_v<C> );
+
+StateArena::~StateArena()
+{}
+
+size_t StateArena::allocate( const size_t count )
+{
+	assert( !committed );
+	const auto offset = this->count;
+	this->count += count;
+	return offset;
+}
+
+void StateArena::commit()
+{
+	assert( !committed );
+	committed = true;
+	if( count == 0 ) {
+		return;
+	}
+	memory.reset( static_cast<C*>(
+			::operator new( count * sizeof(C), std::align_val_t( alignment ) )
+	) );
+	std::uninitialized_fill_n( data(), count, C(0,0) );
+}
+
+size_t StateArena::bytes() const
+{
+	if( !memory ) {
+		return 0;
+	}
+	// rounded to full cache lines:
+	return (count * sizeof(C) + alignment - 1) / alignment * alignment;
+}
+
+void StateArena::reset()
+{
+	std::fill_n( data(), count, C(0,0) );
+}
+
+void StateArena::save( Snapshot* snapshot ) const
+{
+	snapshot->assign( data(), data() + count );
+}
+
+void StateArena::restore( const Snapshot& snapshot )
+{
+	assert( snapshot.size() == count );
+	std::copy_n( snapshot.data(), std::min( snapshot.size(), count ), data() );
+}
@@ -0,0 +1,111 @@
+#include "fge/model/stft.h"
+#include <cmath>
+#include <numbers>
+
+
+STFT::STFT( const SpectrumSettings& settings )
+	: settings( settings )
+	, window( makeWindow( settings.window, settings.windowSize ) )
+	, windowGain( 0 )
+	, history( settings.windowSize, 0 )
+	, work( settings.windowSize )
+	, frame( binCount(), minDB )
+{
+	for( auto w : window ) {
+		windowGain += w;
+	}
+	// a sinusoid of amplitude 1 shows
+	// with magnitude 1 (0dB):
+	windowGain = (windowGain > 0) ? (2 / windowGain) : 1;
+	if( this->settings.hopSize == 0 ) {
+		this->settings.hopSize = 1;
+	}
+	// create the plan now, not
+	// on the first frame:
+	fftPlan( settings.windowSize );
+}
+
+const SpectrumSettings& STFT::getSettings() const
+{
+	return settings;
+}
+
+uint STFT::binCount() const
+{
+	return settings.windowSize/2 + 1;
+}
+
+void STFT::process(
+		const float* samples,
+		const size_t count,
+		FrameCallback onFrame
+)
+{
+	const size_t size = history.size();
+	if( size == 0 ) {
+		return;
+	}
+	for( size_t i=0; i<count; i++ ) {
+		history[writePos] = samples[i];
+		writePos = (writePos + 1) % size;
+		filled = std::min( filled + 1, size );
+		sinceLastFrame++;
+		if( filled == size && sinceLastFrame >= settings.hopSize ) {
+			sinceLastFrame = 0;
+			computeFrame();
+			onFrame( frame );
+		}
+	}
+}
+
+void STFT::reset()
+{
+	std::ranges::fill( history, 0 );
+	writePos = 0;
+	filled = 0;
+	sinceLastFrame = 0;
+}
+
+void STFT::computeFrame()
+{
+	const size_t size = history.size();
+	// oldest sample first:
+	for( size_t i=0; i<size; i++ ) {
+		work[i] = FFTPlan::value_t( history[(writePos + i) % size] * window[i], 0 );
+	}
+	fftPlan( size ).forward( work.data() );
+	for( size_t k=0; k<frame.size(); k++ ) {
+		const auto magnitude = std::abs( work[k] ) * windowGain;
+		frame[k] = std::max( minDB, float(20 * std::log10( magnitude + 1e-12 )) );
+	}
+}
+
+std::vector<float> makeWindow(
+		const WindowType type,
+		const uint size
+)
+{
+	std::vector<float> ret( size, 1 );
+	if( size <= 1 ) {
+		return ret;
+	}
+	const double scale = 2 * std::numbers::pi / double(size);
+	for( uint i=0; i<size; i++ ) {
+		const double phase = scale * i;
+		switch( type ) {
+			case WindowType::Rectangular:
+				ret[i] = 1;
+			break;
+			case WindowType::Hann:
+				ret[i] = 0.5 - 0.5 * std::cos( phase );
+			break;
+			case WindowType::Hamming:
+				ret[i] = 0.54 - 0.46 * std::cos( phase );
+			break;
+			case WindowType::Blackman:
+				ret[i] = 0.42 - 0.5 * std::cos( phase ) + 0.08 * std::cos( 2 * phase );
+			break;
+		}
+	}
+	return ret;
+}
@@ -0,0 +1,295 @@
+#include "fge/render/audio_file_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#ifdef FGE_WITH_FLAC
+#include <FLAC/stream_encoder.h>
+#endif
+
+
+namespace intern {
+
+	uint bytesPerSample( const SampleFormat format )
+	{
+		switch( format ) {
+			case SampleFormat::Int16: return 2;
+			case SampleFormat::Int24: return 3;
+			case SampleFormat::Float32: return 4;
+		}
+		return 2;
+	}
+
+	int32_t quantize( const float sample, const SampleFormat format )
+	{
+		const double maxValue = (format == SampleFormat::Int24)
+			? double((1 << 23) - 1)
+			: double((1 << 15) - 1);
+		return int32_t( std::lround(
+					std::clamp( double(sample), -1.0, 1.0 ) * maxValue
+		));
+	}
+
+	// RIFF is little endian:
+	template <typename Int>
+	void writeLE( std::ostream& stream, const Int value, const uint size = sizeof(Int) )
+	{
+		for( uint i=0; i<size; i++ ) {
+			stream.put( char( (uint64_t(value) >> (8*i)) & 0xff ) );
+		}
+	}
+
+} // namespace intern
+
+/*******************
+ * WavWriter
+ ******************/
+
+class WavWriter:
+	public AudioFileWriter
+{
+	public:
+		virtual ~WavWriter() {
+			close();
+		}
+
+		virtual MaybeError open(
+				const QString& path,
+				const AudioFileSettings& settings
+		) override {
+			this->settings = settings;
+			dataSize = 0;
+			stream.open( path.toStdString(), std::ios::binary | std::ios::trunc );
+			if( !stream ) {
+				return QString("failed to open '%1'").arg( path );
+			}
+			writeHeader();
+			return {};
+		}
+
+		virtual MaybeError write(
+				const std::vector<float>& samples
+		) override {
+			if( !stream.is_open() ) {
+				return "file not open";
+			}
+			buffer.clear();
+			for( auto sample : samples ) {
+				if( settings.sampleFormat == SampleFormat::Float32 ) {
+					uint32_t bits;
+					std::memcpy( &bits, &sample, sizeof(bits) );
+					appendLE( bits, 4 );
+				}
+				else {
+					appendLE(
+							uint32_t( intern::quantize( sample, settings.sampleFormat ) ),
+							intern::bytesPerSample( settings.sampleFormat )
+					);
+				}
+			}
+			stream.write( buffer.data(), buffer.size() );
+			dataSize += buffer.size();
+			if( !stream ) {
+				return "failed to write samples";
+			}
+			return {};
+		}
+
+		virtual MaybeError close() override {
+			if( !stream.is_open() ) {
+				return {};
+			}
+			// RIFF chunks are word aligned:
+			if( dataSize % 2 ) {
+				stream.put( 0 );
+			}
+			// patch sizes into the header:
+			writeHeader();
+			stream.close();
+			if( stream.fail() ) {
+				return "failed to finalize file";
+			}
+			return {};
+		}
+
+	private:
+		void writeHeader() {
+			const uint bytesPerSample = intern::bytesPerSample( settings.sampleFormat );
+			const uint16_t formatTag = (settings.sampleFormat == SampleFormat::Float32)
+				? 3 // WAVE_FORMAT_IEEE_FLOAT
+				: 1 // WAVE_FORMAT_PCM
+			;
+			const uint16_t channels = 1;
+			stream.seekp( 0 );
+			stream.write( "RIFF", 4 );
+			intern::writeLE<uint32_t>( stream, 36 + dataSize + (dataSize % 2) );
+			stream.write( "WAVE", 4 );
+			// fmt chunk:
+			stream.write( "fmt ", 4 );
+			intern::writeLE<uint32_t>( stream, 16 );
+			intern::writeLE<uint16_t>( stream, formatTag );
+			intern::writeLE<uint16_t>( stream, channels );
+			intern::writeLE<uint32_t>( stream, settings.samplerate );
+			intern::writeLE<uint32_t>( stream, settings.samplerate * channels * bytesPerSample );
+			intern::writeLE<uint16_t>( stream, channels * bytesPerSample );
+			intern::writeLE<uint16_t>( stream, 8 * bytesPerSample );
+			// data chunk:
+			stream.write( "data", 4 );
+			intern::writeLE<uint32_t>( stream, dataSize );
+			stream.seekp( 0, std::ios::end );
+		}
+
+		void appendLE( const uint32_t value, const uint size ) {
+			for( uint i=0; i<size; i++ ) {
+				buffer.push_back( char( (value >> (8*i)) & 0xff ) );
+			}
+		}
+
+	private:
+		AudioFileSettings settings;
+		std::ofstream stream;
+		uint32_t dataSize = 0;
+		std::vector<char> buffer;
+};
+
+/*******************
+ * FlacWriter
+ ******************/
+
+#ifdef FGE_WITH_FLAC
+
+class FlacWriter:
+	public AudioFileWriter
+{
+	public:
+		virtual ~FlacWriter() {
+			close();
+		}
+
+		virtual MaybeError open(
+				const QString& path,
+				const AudioFileSettings& settings
+		) override {
+			if( settings.sampleFormat == SampleFormat::Float32 ) {
+				return "FLAC does not support float samples";
+			}
+			this->settings = settings;
+			encoder = FLAC__stream_encoder_new();
+			if( !encoder ) {
+				return "failed to create FLAC encoder";
+			}
+			bool ok = true;
+			ok &= FLAC__stream_encoder_set_channels( encoder, 1 );
+			ok &= FLAC__stream_encoder_set_bits_per_sample( encoder,
+					8 * intern::bytesPerSample( settings.sampleFormat )
+			);
+			ok &= FLAC__stream_encoder_set_sample_rate( encoder, settings.samplerate );
+			ok &= FLAC__stream_encoder_set_compression_level( encoder, 5 );
+			if( !ok ) {
+				close();
+				return "failed to configure FLAC encoder";
+			}
+			const auto status = FLAC__stream_encoder_init_file(
+					encoder,
+					path.toStdString().c_str(),
+					nullptr, nullptr
+			);
+			if( status != FLAC__STREAM_ENCODER_INIT_STATUS_OK ) {
+				FLAC__stream_encoder_delete( encoder );
+				encoder = nullptr;
+				return QString("failed to open '%1': %2")
+					.arg( path )
+					.arg( FLAC__StreamEncoderInitStatusString[status] );
+			}
+			return {};
+		}
+
+		virtual MaybeError write(
+				const std::vector<float>& samples
+		) override {
+			if( !encoder ) {
+				return "file not open";
+			}
+			buffer.resize( samples.size() );
+			std::ranges::transform( samples, buffer.begin(), [this](auto sample) {
+					return FLAC__int32( intern::quantize( sample, settings.sampleFormat ) );
+			});
+			if( !FLAC__stream_encoder_process_interleaved( encoder, buffer.data(), buffer.size() ) ) {
+				return "failed to encode samples";
+			}
+			return {};
+		}
+
+		virtual MaybeError close() override {
+			if( !encoder ) {
+				return {};
+			}
+			const bool ok = FLAC__stream_encoder_finish( encoder );
+			FLAC__stream_encoder_delete( encoder );
+			encoder = nullptr;
+			if( !ok ) {
+				return "failed to finalize file";
+			}
+			return {};
+		}
+
+	private:
+		AudioFileSettings settings;
+		FLAC__StreamEncoder* encoder = nullptr;
+		std::vector<FLAC__int32> buffer;
+};
+
+#endif
+
+/*******************
+ * Utils
+ ******************/
+
+AudioFileFormat audioFileFormatFromPath(
+		const QString& path
+)
+{
+	if( path.toLower().endsWith( ".flac" ) ) {
+		return AudioFileFormat::Flac;
+	}
+	return AudioFileFormat::Wav;
+}
+
+bool isAudioFileFormatSupported(
+		const AudioFileFormat format
+)
+{
+	switch( format ) {
+		case AudioFileFormat::Wav:
+			return true;
+		case AudioFileFormat::Flac:
+#ifdef FGE_WITH_FLAC
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+/*******************
+ * Fabric method:
+ ******************/
+
+ErrorOrValue<std::unique_ptr<AudioFileWriter>> audioFileWriterFactory(
+		const AudioFileFormat format
+)
+{
+	switch( format ) {
+		case AudioFileFormat::Wav:
+			return std::unique_ptr<AudioFileWriter>( new WavWriter() );
+		case AudioFileFormat::Flac:
+#ifdef FGE_WITH_FLAC
+			return std::unique_ptr<AudioFileWriter>( new FlacWriter() );
+#else
+			return std::unexpected( Error("built without FLAC support") );
+#endif
+	}
+	return std::unexpected( Error("unknown audio file format") );
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <memory>
+#include <vector>
+
+
+enum class AudioFileFormat {
+	Wav,
+	Flac
+};
+
+enum class SampleFormat {
+	Int16,
+	Int24,
+	Float32
+};
+
+struct AudioFileSettings {
+	AudioFileFormat format = AudioFileFormat::Wav;
+	SampleFormat sampleFormat = SampleFormat::Int16;
+	uint samplerate = 44100;
+};
+
+/**
+ * Sink for rendered audio.
+ * Mono, samples in [-1,1].
+ */
+class AudioFileWriter
+{
+	public:
+		virtual ~AudioFileWriter() {};
+
+		virtual MaybeError open(
+				const QString& path,
+				const AudioFileSettings& settings
+		) = 0;
+		virtual MaybeError write(
+				const std::vector<float>& samples
+		) = 0;
+		virtual MaybeError close() = 0;
+};
+
+/**
+ * Format from the file suffix:
+ * ".flac" -> AudioFileFormat::Flac,
+ * anything else -> AudioFileFormat::Wav
+ */
+AudioFileFormat audioFileFormatFromPath(
+		const QString& path
+);
+
+bool isAudioFileFormatSupported(
+		const AudioFileFormat format
+);
+
+/*******************
+ * Fabric method:
+ ******************/
+
+ErrorOrValue<std::unique_ptr<AudioFileWriter>> audioFileWriterFactory(
+		const AudioFileFormat format
+);
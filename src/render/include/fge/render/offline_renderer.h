@@ -0,0 +1,82 @@
+#pragma once
+
+#include "fge/model/model.h"
+#include "fge/render/audio_file_writer.h"
+#include <chrono>
+#include <functional>
+#include <future>
+
+
+struct RenderSettings {
+	uint samplerate = 44100;
+	double duration = 1; // seconds
+	uint blockSize = 1024;
+};
+
+struct RenderStatistics {
+	// per block render times
+	// (as in the realtime audio worker):
+	Statistics blockStatistics;
+	PlaybackPosition samplesRendered = 0;
+	std::chrono::microseconds renderTime{0};
+
+	// audio time / wall clock time:
+	double realtimeFactor(const uint samplerate) const;
+};
+
+/**
+ * Renders the model into a file
+ * without a sound server and as fast
+ * as the CPU allows.
+ *
+ * Drives the model the same way
+ * the `AudioWorker` does:
+ * `valuesToBuffer` for every block,
+ * `betweenAudio` after every block.
+ *
+ * Before rendering, audio scheduling
+ * is switched on (if necessary)
+ * and the master envelope is ramped
+ * up during a discarded pre-roll.
+ * Rendering itself always starts
+ * at position 0 and from the initial
+ * function state, so output
+ * is deterministic.
+ */
+class OfflineRenderer
+{
+	public:
+		using BlockSink = std::function<MaybeError(const std::vector<float>& block)>;
+	public:
+		OfflineRenderer(
+				Model* model,
+				const RenderSettings& settings
+		);
+
+		const RenderSettings& getSettings() const;
+
+		ErrorOrValue<RenderStatistics> render(
+				const QString& path,
+				const AudioFileSettings& fileSettings
+		);
+		ErrorOrValue<RenderStatistics> render(
+				AudioFileWriter* writer
+		);
+		ErrorOrValue<RenderStatistics> render(
+				BlockSink sink
+		);
+
+	private:
+		// the time spent in `valuesToBuffer`:
+		std::chrono::nanoseconds renderBlock(
+				std::vector<float>* buffer
+		);
+		void pumpUntil(
+				std::future<void>& signal
+		);
+
+	private:
+		Model* model;
+		RenderSettings settings;
+		PlaybackPosition position = 0;
+};
@@ -0,0 +1,183 @@
+#include "fge/render/offline_renderer.h"
+#include "fge/shared/rt_safety.h"
+#include <chrono>
+#include <future>
+#include <QDebug>
+
+using namespace std::chrono_literals;
+using microsec = std::chrono::microseconds;
+
+
+/********************
+ * RenderStatistics
+*********************/
+
+double RenderStatistics::realtimeFactor(const uint samplerate) const
+{
+	if( renderTime.count() == 0 ) {
+		return 0;
+	}
+	const double audioTime = double(samplesRendered) / double(samplerate);
+	const double wallTime = double(renderTime.count()) / 1000000.0;
+	return audioTime / wallTime;
+}
+
+/********************
+ * OfflineRenderer
+*********************/
+
+OfflineRenderer::OfflineRenderer(
+		Model* model,
+		const RenderSettings& settings
+)
+	: model(model)
+	, settings(settings)
+{}
+
+const RenderSettings& OfflineRenderer::getSettings() const
+{
+	return settings;
+}
+
+ErrorOrValue<RenderStatistics> OfflineRenderer::render(
+		const QString& path,
+		const AudioFileSettings& fileSettings
+)
+{
+	auto maybeWriter = audioFileWriterFactory( fileSettings.format );
+	if( !maybeWriter ) {
+		return std::unexpected( maybeWriter.error() );
+	}
+	auto writer = std::move( maybeWriter.value() );
+	{
+		auto adjustedSettings = fileSettings;
+		adjustedSettings.samplerate = settings.samplerate;
+		if( auto maybeError = writer->open( path, adjustedSettings ) ) {
+			return std::unexpected( maybeError.value() );
+		}
+	}
+	auto ret = render( writer.get() );
+	if( auto maybeError = writer->close() ) {
+		return std::unexpected( maybeError.value() );
+	}
+	return ret;
+}
+
+ErrorOrValue<RenderStatistics> OfflineRenderer::render(
+		AudioFileWriter* writer
+)
+{
+	return render( [writer](const auto& block) {
+			return writer->write( block );
+	});
+}
+
+ErrorOrValue<RenderStatistics> OfflineRenderer::render(
+		BlockSink sink
+)
+{
+	if( settings.samplerate == 0 || settings.blockSize == 0 ) {
+		return std::unexpected( Error("invalid render settings") );
+	}
+	const PlaybackPosition samplesTotal = std::llround( settings.duration * settings.samplerate );
+	std::vector<float> buffer( settings.blockSize, 0 );
+
+	// pre-roll (discarded):
+	const bool wasSchedulingEnabled = model->getAudioSchedulingEnabled();
+	position = 0;
+	if( !wasSchedulingEnabled ) {
+		auto enabled = std::async( std::launch::async, [this]{
+				model->setAudioSchedulingEnabled( true );
+		});
+		pumpUntil( enabled );
+	}
+	// the number of pre-roll blocks
+	// depends on timing, start from
+	// the initial function state:
+	model->resetAudioState();
+
+	// render:
+	RenderStatistics statistics;
+	statistics.blockStatistics.deadline =
+		1000000us / settings.samplerate * settings.blockSize;
+	position = 0;
+	MaybeError maybeError = {};
+	std::chrono::nanoseconds blocksTime{0};
+	uint64_t blocks = 0;
+	const auto t0{std::chrono::steady_clock::now()};
+	while( statistics.samplesRendered < samplesTotal ) {
+		const auto blockSize = std::min<PlaybackPosition>(
+				settings.blockSize,
+				samplesTotal - statistics.samplesRendered
+		);
+		buffer.resize( blockSize );
+		std::chrono::nanoseconds diff;
+		{
+			// checked like the audio thread
+			// (pre-roll and sink are not):
+			rt_safety::Realtime realtime;
+			diff = renderBlock( &buffer );
+		}
+		blocksTime += diff;
+		blocks++;
+		statistics.blockStatistics.max_time = std::max(
+				statistics.blockStatistics.max_time,
+				std::chrono::duration_cast<microsec>( diff )
+		);
+		statistics.samplesRendered += blockSize;
+		maybeError = sink( buffer );
+		if( maybeError ) {
+			break;
+		}
+	}
+	const auto t1{std::chrono::steady_clock::now()};
+	statistics.renderTime = std::chrono::duration_cast<microsec>(t1 - t0);
+	if( blocks > 0 ) {
+		statistics.blockStatistics.avg_time =
+			std::chrono::duration_cast<microsec>( blocksTime / blocks );
+	}
+
+	// restore previous state:
+	if( !wasSchedulingEnabled ) {
+		auto disabled = std::async( std::launch::async, [this]{
+				model->setAudioSchedulingEnabled( false );
+		});
+		pumpUntil( disabled );
+	}
+	if( maybeError ) {
+		return std::unexpected( maybeError.value() );
+	}
+	return statistics;
+}
+
+std::chrono::nanoseconds OfflineRenderer::renderBlock(
+		std::vector<float>* buffer
+)
+{
+	const auto t0{std::chrono::steady_clock::now()};
+	model->valuesToBuffer(
+			buffer,
+			position,
+			settings.samplerate
+	);
+	const auto t1{std::chrono::steady_clock::now()};
+	position += buffer->size();
+	model->betweenAudio( position, settings.samplerate );
+	return t1 - t0;
+}
+
+/* keep the audio clock running
+ * until a blocking model call
+ * (waiting for the audio thread)
+ * returns:
+ */
+void OfflineRenderer::pumpUntil(
+		std::future<void>& signal
+)
+{
+	std::vector<float> discard( settings.blockSize, 0 );
+	while( signal.wait_for( 0s ) != std::future_status::ready ) {
+		renderBlock( &discard );
+	}
+	signal.get();
+}
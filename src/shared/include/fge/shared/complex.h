@@ -43,8 +43,8 @@ namespace cmplx
       inline complex_t& operator  =(const complex_t& r) { c_  = r.c_; return *this; }
       inline complex_t& operator +=(const complex_t& r) { c_ += r.c_; return *this; }
       inline complex_t& operator -=(const complex_t& r) { c_ -= r.c_; return *this; }
-      inline complex_t& operator *=(const complex_t& r) { c_ *= r.c_; return *this; }
-      inline complex_t& operator /=(const complex_t& r) { c_ /= r.c_; return *this; }
+      inline complex_t& operator *=(const complex_t& r);
+      inline complex_t& operator /=(const complex_t& r);
 
       inline complex_t& operator  =(const double r) { c_  = r; return *this; }
       inline complex_t& operator +=(const double r) { c_ += r; return *this; }
@@ -70,10 +70,33 @@ namespace cmplx
       std::complex<double> c_;
    };
 
+   /*
+    * Most values in formulas are real.
+    * Real operands skip the full complex
+    * arithmetic (including the inf/nan
+    * handling of std::complex):
+    */
+   inline bool is_real(const complex_t& v) { return (v.c_.imag() == 0.0); }
+
    inline complex_t operator+(const complex_t r0, const complex_t r1) { return complex_t(r0.c_ + r1.c_); }
    inline complex_t operator-(const complex_t r0, const complex_t r1) { return complex_t(r0.c_ - r1.c_); }
-   inline complex_t operator*(const complex_t r0, const complex_t r1) { return complex_t(r0.c_ * r1.c_); }
-   inline complex_t operator/(const complex_t r0, const complex_t r1) { return complex_t(r0.c_ / r1.c_); }
+
+   inline complex_t operator*(const complex_t r0, const complex_t r1)
+   {
+      if (is_real(r0) && is_real(r1))
+         return complex_t(r0.c_.real() * r1.c_.real(), 0.0);
+      return complex_t(r0.c_ * r1.c_);
+   }
+
+   inline complex_t operator/(const complex_t r0, const complex_t r1)
+   {
+      if (is_real(r1))
+         return complex_t(r0.c_.real() / r1.c_.real(), r0.c_.imag() / r1.c_.real());
+      return complex_t(r0.c_ / r1.c_);
+   }
+
+   inline complex_t& complex_t::operator *=(const complex_t& r) { return (*this = *this * r); }
+   inline complex_t& complex_t::operator /=(const complex_t& r) { return (*this = *this / r); }
 
 
    inline bool operator< (const complex_t c0, const complex_t c1) { return std::norm(c0.c_) <  std::norm(c1.c_); }
@@ -159,25 +182,33 @@ namespace cmplx
       }
    }
 
+   // real arguments with real results use the real functions:
+   #define complex_real_fast_path(Func, Condition)                         \
+   if (is_real(v) && (Condition))                                         \
+      return complex_t(std::Func(v.c_.real()), 0.0);                      \
+
    inline complex_t   abs(const complex_t v) { return complex_t(std::abs  (v.c_)); }
    inline complex_t  acos(const complex_t v) { return complex_t(std::acos (v.c_)); }
    inline complex_t  asin(const complex_t v) { return complex_t(std::asin (v.c_)); }
-   inline complex_t  atan(const complex_t v) { return complex_t(std::atan (v.c_)); }
+   inline complex_t  atan(const complex_t v) { complex_real_fast_path(atan, true) return complex_t(std::atan (v.c_)); }
    inline complex_t  ceil(const complex_t v) { return complex_t(std::ceil (v.c_.real()),std::ceil (v.c_.imag())); }
-   inline complex_t   cos(const complex_t v) { return complex_t(std::cos  (v.c_)); }
-   inline complex_t  cosh(const complex_t v) { return complex_t(std::cosh (v.c_)); }
-   inline complex_t   exp(const complex_t v) { return complex_t(std::exp  (v.c_)); }
+   inline complex_t   cos(const complex_t v) { complex_real_fast_path(cos, true) return complex_t(std::cos  (v.c_)); }
+   inline complex_t  cosh(const complex_t v) { complex_real_fast_path(cosh, true) return complex_t(std::cosh (v.c_)); }
+   inline complex_t   exp(const complex_t v) { complex_real_fast_path(exp, true) return complex_t(std::exp  (v.c_)); }
    inline complex_t floor(const complex_t v) { return complex_t(std::floor(v.c_.real()),std::floor(v.c_.imag())); }
-   inline complex_t   log(const complex_t v) { return complex_t(std::log  (v.c_)); }
-   inline complex_t log10(const complex_t v) { return complex_t(std::log10(v.c_)); }
-   inline complex_t  log2(const complex_t v) { return complex_t(std::log(v.c_) / details::constant::log2.c_); }
+   inline complex_t   log(const complex_t v) { complex_real_fast_path(log, v.c_.real() >= 0.0) return complex_t(std::log  (v.c_)); }
+   inline complex_t log10(const complex_t v) { complex_real_fast_path(log10, v.c_.real() >= 0.0) return complex_t(std::log10(v.c_)); }
+   inline complex_t  log2(const complex_t v) { complex_real_fast_path(log2, v.c_.real() >= 0.0) return complex_t(std::log(v.c_) / details::constant::log2.c_); }
    inline complex_t   neg(const complex_t v) { return complex_t(-1.0 * v.c_); }
    inline complex_t   pos(const complex_t v) { return v;                      }
-   inline complex_t   sin(const complex_t v) { return complex_t(std::sin  (v.c_)); }
-   inline complex_t  sinh(const complex_t v) { return complex_t(std::sinh (v.c_)); }
-   inline complex_t  sqrt(const complex_t v) { return complex_t(std::sqrt (v.c_)); }
-   inline complex_t   tan(const complex_t v) { return complex_t(std::tan  (v.c_)); }
-   inline complex_t  tanh(const complex_t v) { return complex_t(std::tanh (v.c_)); }
+   inline complex_t   sin(const complex_t v) { complex_real_fast_path(sin, true) return complex_t(std::sin  (v.c_)); }
+   inline complex_t  sinh(const complex_t v) { complex_real_fast_path(sinh, true) return complex_t(std::sinh (v.c_)); }
+   inline complex_t  sqrt(const complex_t v) { complex_real_fast_path(sqrt, v.c_.real() >= 0.0) return complex_t(std::sqrt (v.c_)); }
+   inline complex_t   tan(const complex_t v) { complex_real_fast_path(tan, true) return complex_t(std::tan  (v.c_)); }
+   inline complex_t  tanh(const complex_t v) { complex_real_fast_path(tanh, true) return complex_t(std::tanh (v.c_)); }
+
+   #undef complex_real_fast_path
+
    inline complex_t   cot(const complex_t v) { return complex_t(1.0 / std::tan(v.c_)); }
    inline complex_t   sec(const complex_t v) { return complex_t(1.0 / std::cos(v.c_)); }
    inline complex_t   csc(const complex_t v) { return complex_t(1.0 / std::sin(v.c_)); }
@@ -190,7 +221,30 @@ namespace cmplx
    inline complex_t trunc(const complex_t v) { return complex_t((double)static_cast<long long>(v.c_.real()));        }
 
    inline complex_t modulus(const complex_t v0, const complex_t v1) { return complex_t(fmod(v0.c_.real() , v1.c_.real()),0); }
-   inline complex_t     pow(const complex_t v0, const complex_t v1) { return complex_t(std::pow(v0.c_,v1.c_)            ); }
+   inline complex_t     pow(const complex_t v0, const complex_t v1)
+   {
+      if (is_real(v1))
+      {
+         const double e = v1.c_.real();
+         // small integer exponents by squaring,
+         // exact for real bases (e.g. x^2, x^3):
+         if ((e == std::trunc(e)) && (std::abs(e) <= 64.0))
+         {
+            complex_t ret(1.0, 0.0);
+            complex_t base = v0;
+            for (unsigned int n = static_cast<unsigned int>(std::abs(e)); n != 0; n >>= 1)
+            {
+               if (n & 1u)
+                  ret *= base;
+               base *= base;
+            }
+            return (e < 0.0) ? complex_t(1.0, 0.0) / ret : ret;
+         }
+         if (is_real(v0) && (v0.c_.real() >= 0.0))
+            return complex_t(std::pow(v0.c_.real(), e), 0.0);
+      }
+      return complex_t(std::pow(v0.c_,v1.c_));
+   }
    inline complex_t    logn(const complex_t v0, const complex_t v1) { return complex_t(std::log(v0.c_) / std::log(v1.c_)); }
    inline complex_t    root(const complex_t v0, const complex_t v1) { return pow(v0,complex_t(1.0) / v1);                  }
    inline complex_t   atan2(const complex_t v0, const complex_t v1) { return complex_t(std::atan2(v0.c_.real(),v0.c_.imag()),std::atan2(v1.c_.real(),v1.c_.imag())); }
@@ -1,7 +1,14 @@
 #pragma once
+#include "fge/shared/lock_statistics.h"
+#include "fge/shared/rt_safety.h"
+#include "fge/shared/tracing.h"
+#include <array>
+#include <atomic>
 #include <concepts>
+#include <cstring>
 #include <optional>
 #include <mutex>
+#include <shared_mutex>
 #include <QDebug>
 #include <thread>
 #include <type_traits>
@@ -10,6 +17,89 @@
 #define LOG_MUTEX
 #endif
 
+#if defined(FGE_TRACING) || defined(FGE_MUTEX_STATS) || defined(FGE_RT_SAFETY)
+#define FGE_INSTRUMENT_LOCKS
+#endif
+
+#ifdef FGE_INSTRUMENT_LOCKS
+/**
+ * Wraps a lock `L` to record contention
+ * (`FGE_MUTEX_STATS`), lock waits
+ * (`FGE_TRACING`) and blocking locks
+ * on realtime threads (`FGE_RT_SAFETY`).
+ * Only constructed in place, neither
+ * copyable nor movable.
+ */
+template <typename L>
+class InstrumentedLock
+{
+	public:
+		template <typename M>
+		InstrumentedLock(
+				M& m,
+				lock_statistics::Counters* counters, // may be `nullptr`
+				const char* traceCategory,
+				const char* name,
+				const bool tryOnly
+		)
+			: l(m, std::try_to_lock)
+			, counters(counters)
+		{
+#ifdef FGE_RT_SAFETY
+			if( !tryOnly ) {
+				rt_safety::checkLock( name );
+			}
+			// reported already, don't report
+			// the underlying pthread lock:
+			rt_safety::Allow allow;
+#endif
+			if( !l && !tryOnly ) {
+				const auto t0 = lock_statistics::now();
+				{
+					FGE_TRACE_SCOPE( traceCategory, name );
+					l.lock();
+				}
+				if( counters ) {
+					counters->contended.fetch_add( 1, std::memory_order_relaxed );
+					counters->recordWait( lock_statistics::now() - t0 );
+				}
+			}
+			if( counters ) {
+				if( l ) {
+					counters->acquisitions.fetch_add( 1, std::memory_order_relaxed );
+					acquired = lock_statistics::now();
+				}
+				else {
+					counters->failed.fetch_add( 1, std::memory_order_relaxed );
+				}
+			}
+		}
+		~InstrumentedLock() {
+			if( l.owns_lock() ) {
+				release();
+			}
+		}
+		InstrumentedLock( const InstrumentedLock& ) = delete;
+		InstrumentedLock& operator=( const InstrumentedLock& ) = delete;
+
+		explicit operator bool() const { return l.owns_lock(); }
+		void unlock() {
+			release();
+			l.unlock();
+		}
+	private:
+		void release() {
+			if( counters ) {
+				counters->recordHold( lock_statistics::now() - acquired );
+			}
+		}
+	private:
+		L l;
+		lock_statistics::Counters* counters;
+		int64_t acquired = 0;
+};
+#endif
+
 template<
 	class T,
   class M=std::mutex,
@@ -32,10 +122,23 @@ public:
 public:
 	// constructors:
   mutex_guarded(const QString& name)
-		:name(name) {}
+		:name(name)
+#ifdef FGE_INSTRUMENT_LOCKS
+		,lockName(tracing::internString(name))
+#endif
+#ifdef FGE_MUTEX_STATS
+		,statistics(lock_statistics::registerGuard(name))
+#endif
+	{}
   explicit mutex_guarded(T in, const QString& name)
 		: data(std::move(in))
 		, name(name)
+#ifdef FGE_INSTRUMENT_LOCKS
+		, lockName(tracing::internString(name))
+#endif
+#ifdef FGE_MUTEX_STATS
+		, statistics(lock_statistics::registerGuard(name))
+#endif
 	{}
 
 	// READ / WRITE data:
@@ -59,6 +162,33 @@ public:
 			LOG_MUTEX_GUARDED( "READ", "released" );
 			return ret;
 		}
+  }
+	/* read access, but exclusive
+	 * wrt. all other readers.
+	 * For reads with side effects on
+	 * (logically mutable) state, e.g.
+	 * evaluating functions:
+	 */
+  auto exclusive_read( auto f ) const {
+		LOG_MUTEX_GUARDED( "EXCLUSIVE READ" );
+		if constexpr ( std::is_same_v<decltype(f(data)), void> ) {
+			{
+				auto l = exclusive_lock();
+				LOG_MUTEX_GUARDED( "EXCLUSIVE READ", "acquired" );
+				f(data);
+			}
+			LOG_MUTEX_GUARDED( "EXCLUSIVE READ", "released" );
+			return;
+		}
+		else {
+			auto ret = [this,f]{
+				auto l = exclusive_lock();
+				LOG_MUTEX_GUARDED( "EXCLUSIVE READ", "acquired" );
+				return f(data);
+			}();
+			LOG_MUTEX_GUARDED( "EXCLUSIVE READ", "released" );
+			return ret;
+		}
   }
   auto write( auto f ) {
 		LOG_MUTEX_GUARDED( "WRITE" );
@@ -137,15 +267,50 @@ private:
   mutable M m;
   T data;
 	const QString name;
+#ifdef FGE_INSTRUMENT_LOCKS
+	const char* lockName;
+#endif
+#ifdef FGE_MUTEX_STATS
+	std::shared_ptr<lock_statistics::Guard> statistics;
+#endif
 private:
+#ifdef FGE_INSTRUMENT_LOCKS
+	using Operation = lock_statistics::Operation;
+	lock_statistics::Counters* counters(const Operation operation) const {
+#ifdef FGE_MUTEX_STATS
+		return &statistics->get(operation);
+#else
+		return nullptr;
+#endif
+	}
+  auto lock() const {
+		return InstrumentedLock<RL<M>>(m, counters(Operation::Read), "lock wait (read)", lockName, false);
+	}
+  auto exclusive_lock() const {
+		return InstrumentedLock<WL<M>>(m, counters(Operation::Write), "lock wait (write)", lockName, false);
+	}
+  auto lock() {
+		return exclusive_lock();
+	}
+  auto try_lock() const {
+		return InstrumentedLock<RL<M>>(m, counters(Operation::TryRead), "", lockName, true);
+	}
+  auto try_lock() {
+		return InstrumentedLock<WL<M>>(m, counters(Operation::TryWrite), "", lockName, true);
+	}
+#else
   auto lock() const {
 		return RL<M>(m);
 	}
+  auto exclusive_lock() const {
+		return WL<M>(m);
+	}
   auto lock() {
 		return WL<M>(m);
 	}
   auto try_lock() const { return RL<M>(m, std::try_to_lock); }
   auto try_lock() { return WL<M>(m, std::try_to_lock); }
+#endif
 	void LOG_MUTEX_GUARDED(const QString& op, const QString& msg = "") const
 	{
 #ifdef LOG_MUTEX
@@ -165,3 +330,96 @@ private:
 #endif
 	}
 };
+
+/**
+ * `read` takes a shared lock,
+ * so readers run concurrently.
+ * Readers must not modify (even mutable)
+ * state, use `exclusive_read` instead.
+ */
+template <class T>
+using shared_mutex_guarded = mutex_guarded<
+	T,
+	std::shared_mutex,
+	std::unique_lock,
+	std::shared_lock
+>;
+
+/**
+ * Sequence lock for small trivially copyable
+ * values (positions, counters...).
+ * Readers never block the writer,
+ * they retry if they observed a write
+ * in progress.
+ * Single writer at a time:
+ * concurrent `write`s are not synchronized.
+ */
+template <class T>
+	requires std::is_trivially_copyable_v<T>
+struct seqlock_guarded {
+
+public:
+	// constructors:
+	seqlock_guarded(const QString& name)
+		: seqlock_guarded(T{}, name)
+	{}
+	explicit seqlock_guarded(T in, const QString& name)
+		: name(name)
+	{
+		store(in);
+	}
+
+	// READ / WRITE data:
+	T read() const {
+		while( true ) {
+			const auto before = sequence.load( std::memory_order_acquire );
+			if( before & 1 ) {
+				std::this_thread::yield();
+				continue;
+			}
+			const T ret = load();
+			std::atomic_thread_fence( std::memory_order_acquire );
+			if( sequence.load( std::memory_order_relaxed ) == before ) {
+				return ret;
+			}
+		}
+	}
+	auto read( auto f ) const {
+		return f( read() );
+	}
+	void write( auto f ) {
+		T value = load();
+		f(value);
+		const auto before = sequence.load( std::memory_order_relaxed );
+		sequence.store( before+1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		store(value);
+		sequence.store( before+2, std::memory_order_release );
+	}
+
+private:
+	// words are atomics, so torn reads
+	// are detected, not undefined behaviour:
+	constexpr static size_t wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+	T load() const {
+		std::array<uint64_t, wordCount> buffer;
+		for( size_t i=0; i<wordCount; i++ ) {
+			buffer[i] = words[i].load( std::memory_order_relaxed );
+		}
+		T ret;
+		std::memcpy( static_cast<void*>(&ret), buffer.data(), sizeof(T) );
+		return ret;
+	}
+	void store(const T& value) {
+		std::array<uint64_t, wordCount> buffer{};
+		std::memcpy( buffer.data(), &value, sizeof(T) );
+		for( size_t i=0; i<wordCount; i++ ) {
+			words[i].store( buffer[i], std::memory_order_relaxed );
+		}
+	}
+
+private:
+	std::atomic<uint64_t> sequence = 0;
+	std::array<std::atomic<uint64_t>, wordCount> words{};
+	const QString name;
+};
@@ -5,6 +5,7 @@
 #include <optional>
 #include <expected>
 #include <chrono>
+#include <cstdint>
 #include "fge/shared/complex_adaptor.h"
 
 using uint = unsigned int;
@@ -43,10 +44,67 @@ struct ParameterDescription {
 	FadeType rampType = FadeType::RampVolume;
 };
 
+enum class WindowType {
+	Rectangular,
+	Hann,
+	Hamming,
+	Blackman
+};
+
+enum class SpectrumDisplay {
+	Spectrum,
+	Spectrogram
+};
+
+struct SpectrumSettings {
+	bool enabled = false;
+	uint windowSize = 2048;
+	uint hopSize = 512;
+	WindowType window = WindowType::Hann;
+	SpectrumDisplay display = SpectrumDisplay::Spectrum;
+
+	// floor of the magnitudes (dB):
+	static constexpr float minDB = -120;
+};
+
+/* block render time percentiles
+ * as fraction of the deadline:
+ */
+struct LatencyPercentiles {
+	double p50 = 0;
+	double p90 = 0;
+	double p99 = 0;
+	double p999 = 0;
+	uint64_t count = 0;
+};
+
 struct Statistics {
 	std::chrono::microseconds avg_time{0};
 	std::chrono::microseconds max_time{0};
 	std::chrono::microseconds deadline{0};
+	// cumulative since the audio client was created:
+	LatencyPercentiles latency = {};
+	uint64_t overruns = 0; // blocks rendered slower than the deadline
+	uint64_t xruns = 0; // reported by jack
+	uint64_t underruns = 0; // jack found no block ready
+	uint64_t silentBlocks = 0; // skipped during expensive model updates
+	std::optional<std::chrono::milliseconds> sinceLastUnderrun = {};
+};
+
+/* cumulative evaluation costs
+ * of one function:
+ */
+struct ProfileCounts {
+	double totalNs = 0; // including upstream functions
+	double selfNs = 0;
+	uint64_t calls = 0;
+	uint64_t samples = 0;
+};
+
+struct NodeStatistics {
+	ProfileCounts audio;
+	ProfileCounts graph;
+	size_t stateBytes = 0;
 };
 
 using ParameterDescriptions = std::map<QString,ParameterDescription>;
@@ -58,7 +116,21 @@ using VariableBindings = std::map<QString, Value>;
 using ParameterBindings = VariableBindings<C>;
 using StateBindings = VariableBindings<std::vector<C>>;
 
+/* index into the parameters of a
+ * function, sorted by name.
+ * Stays valid if the function is
+ * recompiled with the same names:
+ */
+using ParameterHandle = uint;
+
+enum class StateKind {
+	Values,
+	// ring buffer for `delay_read`, `delay_write`:
+	Delay
+};
+
 struct StateDescription {
 	uint size;
+	StateKind kind = StateKind::Values;
 };
 using StateDescriptions = std::map<QString,StateDescription>;
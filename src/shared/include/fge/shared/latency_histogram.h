@@ -0,0 +1,98 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * Fixed bucket histogram of block
+ * render times relative to a deadline.
+ * `record` is wait-free and meant to be
+ * called from the audio thread,
+ * `percentiles` may be called
+ * concurrently from any other thread.
+ */
+class LatencyHistogram
+{
+	public:
+		// buckets per deadline:
+		constexpr static uint resolution = 64;
+		// times >= maxRatio * deadline
+		// end up in the last bucket:
+		constexpr static uint maxRatio = 4;
+		constexpr static uint bucketCount = resolution * maxRatio + 1;
+
+		void record(
+				const std::chrono::nanoseconds time,
+				const std::chrono::nanoseconds deadline
+		)
+		{
+			if( deadline.count() <= 0 ) {
+				return;
+			}
+			const auto index = std::min<uint64_t>(
+					uint64_t(std::max<int64_t>(time.count(), 0)) * resolution / uint64_t(deadline.count()),
+					bucketCount - 1
+			);
+			buckets[index].fetch_add( 1, std::memory_order_relaxed );
+			if( time > deadline ) {
+				overruns.fetch_add( 1, std::memory_order_relaxed );
+			}
+		}
+
+		uint64_t getOverruns() const
+		{
+			return overruns.load( std::memory_order_relaxed );
+		}
+
+		void clear()
+		{
+			for( auto& bucket : buckets ) {
+				bucket.store( 0, std::memory_order_relaxed );
+			}
+			overruns.store( 0, std::memory_order_relaxed );
+		}
+
+		/* upper bucket bounds
+		 * as fraction of the deadline.
+		 * The snapshot is not atomic as a whole,
+		 * which is good enough for monitoring.
+		 */
+		LatencyPercentiles percentiles() const
+		{
+			std::array<uint64_t, bucketCount> counts;
+			uint64_t total = 0;
+			for( uint i=0; i<bucketCount; i++ ) {
+				counts[i] = buckets[i].load( std::memory_order_relaxed );
+				total += counts[i];
+			}
+			LatencyPercentiles ret;
+			ret.count = total;
+			if( total == 0 ) {
+				return ret;
+			}
+			auto percentile = [&counts,total](const double p) {
+				const auto rank = uint64_t(p * double(total - 1)) + 1;
+				uint64_t sum = 0;
+				for( uint i=0; i<bucketCount; i++ ) {
+					sum += counts[i];
+					if( sum >= rank ) {
+						return double(i+1) / resolution;
+					}
+				}
+				return double(bucketCount) / resolution;
+			};
+			ret.p50 = percentile( 0.5 );
+			ret.p90 = percentile( 0.9 );
+			ret.p99 = percentile( 0.99 );
+			ret.p999 = percentile( 0.999 );
+			return ret;
+		}
+
+	private:
+		std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+		std::atomic<uint64_t> overruns = 0;
+};
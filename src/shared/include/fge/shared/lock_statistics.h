@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+
+/**
+ * Contention counters of `mutex_guarded`.
+ * Only collected if compiled with
+ * `FGE_MUTEX_STATS` (cmake -DFGE_MUTEX_STATS=ON).
+ * Counters are split by operation and
+ * by whether the calling thread is
+ * the audio thread.
+ */
+namespace lock_statistics {
+
+	enum class Operation {
+		Read,
+		Write,
+		TryRead,
+		TryWrite
+	};
+	constexpr size_t operationCount = 4;
+
+	const char* operationName( const Operation operation );
+
+	// true for the thread rendering audio.
+	// set once at thread start:
+	bool& isAudioThread();
+
+	inline int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+	}
+
+	struct Counters {
+		std::atomic<uint64_t> acquisitions = 0;
+		// had to wait:
+		std::atomic<uint64_t> contended = 0;
+		// try_* gave up:
+		std::atomic<uint64_t> failed = 0;
+		std::atomic<int64_t> waitNs = 0;
+		std::atomic<int64_t> maxWaitNs = 0;
+		std::atomic<int64_t> holdNs = 0;
+		std::atomic<int64_t> maxHoldNs = 0;
+
+		void recordWait( const int64_t ns );
+		void recordHold( const int64_t ns );
+	};
+
+	// counters of one guard:
+	struct Guard {
+		explicit Guard( const QString& name )
+			: name( name )
+		{}
+		Counters& get( const Operation operation ) {
+			return counters[isAudioThread() ? 1 : 0][size_t(operation)];
+		}
+		const QString name;
+		// [other thread, audio thread][operation]:
+		std::array<std::array<Counters, operationCount>, 2> counters;
+	};
+
+	/* counters stay registered
+	 * after the guard is gone,
+	 * guards with the same name
+	 * are reported separately.
+	 */
+	std::shared_ptr<Guard> registerGuard( const QString& name );
+
+	// human readable table of all guards:
+	QString report();
+	// CSV, one line per guard, thread and operation:
+	QString reportCSV();
+
+	void reset();
+
+} // namespace lock_statistics
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FGE_PROFILER_RDTSC
+#endif
+
+
+/**
+ * Low overhead instrumentation
+ * of function evaluation.
+ * Scopes nest (a function calling
+ * upstream functions), time spent
+ * in nested scopes counts as
+ * "total" but not as "self" time
+ * of the enclosing scope.
+ */
+namespace profiler {
+
+	using ticks_t = uint64_t;
+
+	inline ticks_t now() {
+#ifdef FGE_PROFILER_RDTSC
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+#endif
+	}
+
+	// calibrated on first call (takes ~10ms).
+	// don't call from the audio thread:
+	double ticksPerNanosecond();
+
+	// what the calling thread is
+	// currently evaluating functions for:
+	enum class Context {
+		Audio,
+		Graph,
+		None
+	};
+	constexpr size_t contextCount = 2;
+
+	Context& currentContext();
+
+	// set the context for the current scope:
+	class ContextGuard
+	{
+		public:
+			explicit ContextGuard( const Context context )
+				: previous( currentContext() )
+			{
+				currentContext() = context;
+			}
+			~ContextGuard() {
+				currentContext() = previous;
+			}
+		private:
+			Context previous;
+	};
+
+} // namespace profiler
+
+/**
+ * Counters of one node.
+ * Written by the evaluating thread,
+ * published counters may be read
+ * from any thread.
+ */
+struct ProfileSlot
+{
+	using ticks_t = profiler::ticks_t;
+
+	struct Counters {
+		ticks_t total = 0;
+		ticks_t self = 0;
+		uint64_t calls = 0;
+	};
+	struct Published {
+		// monotonic, consumers take differences:
+		std::atomic<ticks_t> total = 0;
+		std::atomic<ticks_t> self = 0;
+		std::atomic<uint64_t> calls = 0;
+		std::atomic<uint64_t> samples = 0;
+	};
+
+	// add the running counters of
+	// a block (or graph) to the
+	// published ones:
+	void publish(
+			const profiler::Context context,
+			const uint64_t samples
+	);
+	ProfileCounts read(
+			const profiler::Context context
+	) const;
+
+	std::array<Counters, profiler::contextCount> running;
+	std::array<Published, profiler::contextCount> published;
+};
+
+class ProfileScope
+{
+	public:
+		// no-op for `nullptr`
+		// or outside of a context:
+		explicit ProfileScope( ProfileSlot* slot )
+			: slot( (profiler::currentContext() != profiler::Context::None) ? slot : nullptr )
+		{
+			if( this->slot ) {
+				parent = current();
+				current() = this;
+				start = profiler::now();
+			}
+		}
+		~ProfileScope() {
+			if( !slot ) {
+				return;
+			}
+			const auto elapsed = profiler::now() - start;
+			auto& counters = slot->running[size_t(profiler::currentContext())];
+			counters.total += elapsed;
+			counters.self += elapsed - children;
+			counters.calls++;
+			if( parent ) {
+				parent->children += elapsed;
+			}
+			current() = parent;
+		}
+		ProfileScope( const ProfileScope& ) = delete;
+		ProfileScope& operator=( const ProfileScope& ) = delete;
+
+	private:
+		static ProfileScope*& current();
+
+	private:
+		ProfileSlot* slot;
+		ProfileScope* parent = nullptr;
+		profiler::ticks_t start = 0;
+		profiler::ticks_t children = 0;
+};
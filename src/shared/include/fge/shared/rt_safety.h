@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * Detects heap allocations and
+ * blocking locks on realtime threads.
+ * Only active if compiled with
+ * `FGE_RT_SAFETY` (cmake -DFGE_RT_SAFETY=ON),
+ * which replaces `malloc`, `free` & co.
+ * and `pthread_mutex_lock` & co.
+ * (glibc only, not compatible with
+ * sanitizers).
+ *
+ * Threads opt in via `setRealtimeThread`
+ * or `Realtime`. Violations are tagged
+ * with the enclosing `FGE_RT_SCOPE`s and
+ * a backtrace. Recording a violation
+ * neither allocates nor locks.
+ */
+namespace rt_safety {
+
+	constexpr bool enabled() {
+#ifdef FGE_RT_SAFETY
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	enum class ViolationKind {
+		Allocation,
+		Deallocation,
+		Lock
+	};
+
+	const char* kindName( const ViolationKind kind );
+
+	// innermost scopes are kept:
+	constexpr size_t maxTags = 8;
+	constexpr size_t maxFrames = 24;
+	// further violations are only counted:
+	constexpr size_t maxViolations = 256;
+
+	struct Violation {
+		ViolationKind kind;
+		// function or lock name:
+		const char* what;
+		size_t size;
+		std::array<const char*, maxTags> tags;
+		size_t tagCount;
+		std::array<void*, maxFrames> frames;
+		size_t frameCount;
+	};
+
+	// mark the calling thread:
+	void setRealtimeThread( const bool value );
+	bool isRealtimeThread();
+
+	/* for instrumented locks,
+	 * `what` must have static lifetime:
+	 */
+	void checkLock( const char* what );
+
+	uint64_t violationCount();
+	uint64_t violationCount( const ViolationKind kind );
+	// the first `maxViolations`.
+	// call while realtime threads are idle:
+	std::vector<Violation> violations();
+	// with symbolized backtraces:
+	QString report();
+	void reset();
+
+	// realtime for the lifetime of the object:
+	class Realtime
+	{
+		public:
+			Realtime();
+			~Realtime();
+			Realtime( const Realtime& ) = delete;
+			Realtime& operator=( const Realtime& ) = delete;
+		private:
+			bool previous;
+	};
+
+	/* suspends checks on the calling thread,
+	 * for work that is knowingly not
+	 * realtime safe:
+	 */
+	class Allow
+	{
+		public:
+			Allow();
+			~Allow();
+			Allow( const Allow& ) = delete;
+			Allow& operator=( const Allow& ) = delete;
+	};
+
+	// tag violations, `name` must have static lifetime:
+	class Scope
+	{
+		public:
+			explicit Scope( const char* name );
+			~Scope();
+			Scope( const Scope& ) = delete;
+			Scope& operator=( const Scope& ) = delete;
+	};
+
+} // namespace rt_safety
+
+#define FGE_RT_CONCAT_(a,b) a##b
+#define FGE_RT_CONCAT(a,b) FGE_RT_CONCAT_(a,b)
+
+#ifdef FGE_RT_SAFETY
+#define FGE_RT_SCOPE(name) \
+	rt_safety::Scope FGE_RT_CONCAT(rtScope_, __LINE__){ name }
+#else
+#define FGE_RT_SCOPE(name)
+#endif
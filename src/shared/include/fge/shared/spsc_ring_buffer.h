@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Lock-free ring buffer for exactly
+ * one producer and one consumer thread.
+ * Neither side ever blocks or allocates,
+ * so the producer may be the audio thread.
+ * If the consumer does not keep up,
+ * new values are dropped (and counted).
+ */
+template <typename T>
+class SpscRingBuffer
+{
+	public:
+		// capacity is rounded up to a power of 2:
+		explicit SpscRingBuffer( const size_t capacity )
+			: buffer( std::bit_ceil( std::max<size_t>( capacity, 2 ) ) )
+			, mask( buffer.size() - 1 )
+		{}
+
+		size_t capacity() const { return buffer.size(); }
+
+		/* producer: */
+		bool push( const T& value ) {
+			const auto write = writePos.load( std::memory_order_relaxed );
+			const auto read = readPos.load( std::memory_order_acquire );
+			if( write - read >= buffer.size() ) {
+				dropped.fetch_add( 1, std::memory_order_relaxed );
+				return false;
+			}
+			buffer[write & mask] = value;
+			writePos.store( write + 1, std::memory_order_release );
+			return true;
+		}
+
+		/* consumer: */
+		size_t available() const {
+			return writePos.load( std::memory_order_acquire )
+				- readPos.load( std::memory_order_relaxed );
+		}
+
+		size_t pop( T* dst, const size_t maxCount ) {
+			const auto read = readPos.load( std::memory_order_relaxed );
+			const auto write = writePos.load( std::memory_order_acquire );
+			const auto count = std::min<size_t>( write - read, maxCount );
+			for( size_t i=0; i<count; i++ ) {
+				dst[i] = buffer[(read + i) & mask];
+			}
+			readPos.store( read + count, std::memory_order_release );
+			return count;
+		}
+
+		void clear() {
+			readPos.store( writePos.load( std::memory_order_acquire ), std::memory_order_release );
+		}
+
+		size_t droppedCount() const {
+			return dropped.load( std::memory_order_relaxed );
+		}
+
+	private:
+		std::vector<T> buffer;
+		const size_t mask;
+		// written only by the producer:
+		alignas(64) std::atomic<size_t> writePos = 0;
+		// written only by the consumer:
+		alignas(64) std::atomic<size_t> readPos = 0;
+		std::atomic<size_t> dropped = 0;
+};
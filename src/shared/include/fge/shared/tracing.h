@@ -0,0 +1,105 @@
+#pragma once
+
+#include "fge/shared/data.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+/**
+ * Span tracing across threads
+ * (jack, audio worker, model worker,
+ * model update queue, gui).
+ * Only active if compiled with
+ * `FGE_TRACING` (cmake -DFGE_TRACING=ON),
+ * otherwise the macros expand to nothing.
+ *
+ * Every thread records into its own
+ * fixed size ring buffer, recording
+ * is lock free (except for the first
+ * event of a thread, which registers
+ * its buffer).
+ * The buffers can be dumped in
+ * Chrome trace event format (JSON),
+ * which can be loaded into
+ * chrome://tracing or ui.perfetto.dev.
+ */
+namespace tracing {
+
+	constexpr bool enabled() {
+#ifdef FGE_TRACING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// events per thread, older events
+	// are overwritten:
+	constexpr size_t bufferSize = size_t(1) << 15;
+
+	inline int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+	}
+
+	/* names must outlive the trace.
+	 * Returns a pointer to a copy
+	 * with static lifetime.
+	 * Takes a lock, don't call from
+	 * the audio thread:
+	 */
+	const char* internString( const QString& name );
+
+	// name the calling thread in the trace:
+	void setThreadName( const char* name );
+
+	void record(
+			const char* category,
+			const char* name,
+			const int64_t begin,
+			const int64_t end
+	);
+
+	// all buffered events as
+	// chrome trace event JSON:
+	QByteArray chromeTrace();
+	MaybeError writeChromeTrace( const QString& path );
+
+	// drop all buffered events:
+	void clear();
+
+	class Span
+	{
+		public:
+			Span( const char* category, const char* name )
+				: category( category )
+				, name( name )
+				, begin( now() )
+			{}
+			~Span() {
+				record( category, name, begin, now() );
+			}
+			Span( const Span& ) = delete;
+			Span& operator=( const Span& ) = delete;
+		private:
+			const char* category;
+			const char* name;
+			int64_t begin;
+	};
+
+} // namespace tracing
+
+#define FGE_TRACE_CONCAT_(a,b) a##b
+#define FGE_TRACE_CONCAT(a,b) FGE_TRACE_CONCAT_(a,b)
+
+#ifdef FGE_TRACING
+#define FGE_TRACE_SCOPE(category, name) \
+	tracing::Span FGE_TRACE_CONCAT(traceSpan_, __LINE__){ category, name }
+#define FGE_TRACE_THREAD(name) \
+	tracing::setThreadName( name )
+#else
+#define FGE_TRACE_SCOPE(category, name)
+#define FGE_TRACE_THREAD(name)
+#endif
@@ -0,0 +1,170 @@
+#include "fge/shared/lock_statistics.h"
+#include <mutex>
+#include <vector>
+
+
+namespace lock_statistics {
+
+namespace intern {
+
+	struct Registry {
+		std::mutex lock;
+		std::vector<std::shared_ptr<Guard>> guards;
+	};
+
+	Registry& registry() {
+		static Registry value;
+		return value;
+	}
+
+	void updateMax( std::atomic<int64_t>& max, const int64_t value ) {
+		auto current = max.load( std::memory_order_relaxed );
+		while(
+				value > current
+				&& !max.compare_exchange_weak( current, value, std::memory_order_relaxed )
+		) {}
+	}
+
+	std::vector<std::shared_ptr<Guard>> guards() {
+		auto& reg = registry();
+		std::scoped_lock lock( reg.lock );
+		return reg.guards;
+	}
+
+	// call f(guard, isAudio, operation, counters)
+	// for all non empty counters:
+	template <typename Function>
+	void forEachCounters( Function f ) {
+		for( const auto& guard : guards() ) {
+			for( size_t thread=0; thread<2; thread++ ) {
+				for( size_t operation=0; operation<operationCount; operation++ ) {
+					const auto& counters = guard->counters[thread][operation];
+					if(
+							counters.acquisitions.load( std::memory_order_relaxed ) == 0
+							&& counters.failed.load( std::memory_order_relaxed ) == 0
+					) {
+						continue;
+					}
+					f( *guard, thread == 1, Operation(operation), counters );
+				}
+			}
+		}
+	}
+
+	double average( const int64_t sum, const uint64_t count ) {
+		return (count > 0) ? (double(sum) / double(count)) : 0.0;
+	}
+
+} // namespace intern
+
+const char* operationName( const Operation operation )
+{
+	switch( operation ) {
+		case Operation::Read: return "read";
+		case Operation::Write: return "write";
+		case Operation::TryRead: return "try_read";
+		case Operation::TryWrite: return "try_write";
+	}
+	return "";
+}
+
+bool& isAudioThread()
+{
+	thread_local bool value = false;
+	return value;
+}
+
+void Counters::recordWait( const int64_t ns )
+{
+	waitNs.fetch_add( ns, std::memory_order_relaxed );
+	intern::updateMax( maxWaitNs, ns );
+}
+
+void Counters::recordHold( const int64_t ns )
+{
+	holdNs.fetch_add( ns, std::memory_order_relaxed );
+	intern::updateMax( maxHoldNs, ns );
+}
+
+std::shared_ptr<Guard> registerGuard( const QString& name )
+{
+	auto guard = std::make_shared<Guard>( name );
+	auto& reg = intern::registry();
+	std::scoped_lock lock( reg.lock );
+	reg.guards.push_back( guard );
+	return guard;
+}
+
+QString report()
+{
+	QString ret = QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+		.arg( "guard", -10 )
+		.arg( "thread", -6 )
+		.arg( "op", -9 )
+		.arg( "acquired", 10 )
+		.arg( "contended", 10 )
+		.arg( "failed", 8 )
+		.arg( "wait avg/max us", 18 )
+		.arg( "hold avg/max us", 18 );
+	intern::forEachCounters([&ret](const auto& guard, const bool isAudio, const auto operation, const auto& counters) {
+		const auto acquisitions = counters.acquisitions.load( std::memory_order_relaxed );
+		const auto contended = counters.contended.load( std::memory_order_relaxed );
+		ret += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+			.arg( guard.name, -10 )
+			.arg( isAudio ? "audio" : "other", -6 )
+			.arg( operationName( operation ), -9 )
+			.arg( acquisitions, 10 )
+			.arg( contended, 10 )
+			.arg( counters.failed.load( std::memory_order_relaxed ), 8 )
+			.arg( QString("%1/%2")
+					.arg( intern::average( counters.waitNs.load(), contended ) / 1000.0, 0, 'f', 1 )
+					.arg( counters.maxWaitNs.load() / 1000.0, 0, 'f', 1 ),
+				18
+			)
+			.arg( QString("%1/%2")
+					.arg( intern::average( counters.holdNs.load(), acquisitions ) / 1000.0, 0, 'f', 1 )
+					.arg( counters.maxHoldNs.load() / 1000.0, 0, 'f', 1 ),
+				18
+			);
+	});
+	return ret;
+}
+
+QString reportCSV()
+{
+	QString ret = "guard,thread,operation,acquisitions,contended,failed,wait_ns,max_wait_ns,hold_ns,max_hold_ns\n";
+	intern::forEachCounters([&ret](const auto& guard, const bool isAudio, const auto operation, const auto& counters) {
+		ret += QStringList{
+			guard.name,
+			isAudio ? "audio" : "other",
+			operationName( operation ),
+			QString::number( counters.acquisitions.load() ),
+			QString::number( counters.contended.load() ),
+			QString::number( counters.failed.load() ),
+			QString::number( counters.waitNs.load() ),
+			QString::number( counters.maxWaitNs.load() ),
+			QString::number( counters.holdNs.load() ),
+			QString::number( counters.maxHoldNs.load() )
+		}.join(",") + "\n";
+	});
+	return ret;
+}
+
+void reset()
+{
+	for( const auto& guard : intern::guards() ) {
+		for( auto& perThread : guard->counters ) {
+			for( auto& counters : perThread ) {
+				counters.acquisitions = 0;
+				counters.contended = 0;
+				counters.failed = 0;
+				counters.waitNs = 0;
+				counters.maxWaitNs = 0;
+				counters.holdNs = 0;
+				counters.maxHoldNs = 0;
+			}
+		}
+	}
+}
+
+} // namespace lock_statistics
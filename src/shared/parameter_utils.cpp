@@ -64,9 +64,10 @@ QString functionDataDescriptionToString( const FunctionDataDescription& dataDesc
 		;
 	}
 	for( auto [name, value] : dataDescription.stateDescriptions ) {
-		str += QString("state %2 %1\n")
+		str += QString("%3 %2 %1\n")
 			.arg( name )
 			.arg( value.size )
+			.arg( (value.kind == StateKind::Delay) ? "delay" : "state" )
 		;
 	}
 	return str;
@@ -108,7 +109,8 @@ ParseResult parseFunctionDataDescription(
 			if( parseError ) continue;
 			ret.insert({ words.at(2), param });
 		}
-		else if( argOrState == "state" ) {
+		// <state|delay> <size> <name>
+		else if( argOrState == "state" || argOrState == "delay" ) {
 			if( words.size() < 3 ) {
 				continue;
 			}
@@ -117,7 +119,10 @@ ParseResult parseFunctionDataDescription(
 			if( !ok || size < 0 ) {
 				continue;
 			}
-			ret.insert({ words.at(2), StateDescription{ .size = (uint )size } });
+			ret.insert({ words.at(2), StateDescription{
+					.size = (uint )size,
+					.kind = (argOrState == "delay") ? StateKind::Delay : StateKind::Values
+			} });
 		}
 		else {
 			continue;
@@ -0,0 +1,66 @@
+#include "fge/shared/profiler.h"
+#include <thread>
+
+
+namespace profiler {
+
+double ticksPerNanosecond()
+{
+	static const double value = []{
+#ifdef FGE_PROFILER_RDTSC
+		using namespace std::chrono_literals;
+		const auto t0 = std::chrono::steady_clock::now();
+		const auto ticks0 = now();
+		std::this_thread::sleep_for( 10ms );
+		const auto ticks1 = now();
+		const auto t1 = std::chrono::steady_clock::now();
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( t1 - t0 ).count();
+		return double(ticks1 - ticks0) / double(ns);
+#else
+		return 1.0;
+#endif
+	}();
+	return value;
+}
+
+Context& currentContext()
+{
+	thread_local Context context = Context::None;
+	return context;
+}
+
+} // namespace profiler
+
+ProfileScope*& ProfileScope::current()
+{
+	thread_local ProfileScope* scope = nullptr;
+	return scope;
+}
+
+void ProfileSlot::publish(
+		const profiler::Context context,
+		const uint64_t samples
+)
+{
+	auto& counters = running[size_t(context)];
+	auto& dst = published[size_t(context)];
+	dst.total.fetch_add( counters.total, std::memory_order_relaxed );
+	dst.self.fetch_add( counters.self, std::memory_order_relaxed );
+	dst.calls.fetch_add( counters.calls, std::memory_order_relaxed );
+	dst.samples.fetch_add( samples, std::memory_order_relaxed );
+	counters = {};
+}
+
+ProfileCounts ProfileSlot::read(
+		const profiler::Context context
+) const
+{
+	const auto& src = published[size_t(context)];
+	const double ticksPerNs = profiler::ticksPerNanosecond();
+	return ProfileCounts{
+		.totalNs = double(src.total.load( std::memory_order_relaxed )) / ticksPerNs,
+		.selfNs = double(src.self.load( std::memory_order_relaxed )) / ticksPerNs,
+		.calls = src.calls.load( std::memory_order_relaxed ),
+		.samples = src.samples.load( std::memory_order_relaxed )
+	};
+}
@@ -0,0 +1,328 @@
+#include "fge/shared/rt_safety.h"
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+#if defined(FGE_RT_SAFETY) && defined(__GLIBC__)
+#include <cerrno>
+#include <dlfcn.h>
+#include <pthread.h>
+#define FGE_RT_INTERPOSE
+#endif
+
+// thread state is accessed from `malloc`,
+// dynamic tls might allocate itself:
+#ifdef __GNUC__
+#define FGE_RT_TLS_MODEL __attribute__((tls_model("initial-exec")))
+#else
+#define FGE_RT_TLS_MODEL
+#endif
+
+
+namespace rt_safety {
+
+namespace intern {
+
+	struct ThreadState {
+		bool realtime = false;
+		uint allowed = 0;
+		// set while recording a violation
+		// (`backtrace` may allocate):
+		bool recording = false;
+		// scopes (ring of the innermost):
+		size_t depth = 0;
+		std::array<const char*, maxTags> tags = {};
+	};
+
+	FGE_RT_TLS_MODEL thread_local ThreadState threadState;
+
+	struct Slot {
+		std::atomic<bool> complete = false;
+		Violation violation;
+	};
+
+	std::atomic<uint64_t> count = 0;
+	// by `ViolationKind`:
+	std::array<std::atomic<uint64_t>, 3> kindCount = {};
+	std::array<Slot, maxViolations> slots;
+
+#ifdef __GLIBC__
+	// the first call of `backtrace`
+	// loads libgcc, do it early:
+	[[maybe_unused]] const bool backtraceLoaded = []{
+		void* frame = nullptr;
+		backtrace( &frame, 1 );
+		return true;
+	}();
+#endif
+
+	void record(
+			const ViolationKind kind,
+			const char* what,
+			const size_t size
+	) {
+		auto& state = threadState;
+		if( !state.realtime || state.allowed > 0 || state.recording ) {
+			return;
+		}
+		state.recording = true;
+		const auto index = count.fetch_add( 1, std::memory_order_relaxed );
+		kindCount[size_t(kind)].fetch_add( 1, std::memory_order_relaxed );
+		if( index < maxViolations ) {
+			auto& violation = slots[index].violation;
+			violation.kind = kind;
+			violation.what = what;
+			violation.size = size;
+			violation.tagCount = std::min( state.depth, maxTags );
+			for( size_t i=0; i<violation.tagCount; i++ ) {
+				violation.tags[i] = state.tags[(state.depth - violation.tagCount + i) % maxTags];
+			}
+#ifdef __GLIBC__
+			violation.frameCount = size_t( backtrace( violation.frames.data(), int(maxFrames) ) );
+#else
+			violation.frameCount = 0;
+#endif
+			slots[index].complete.store( true, std::memory_order_release );
+		}
+		state.recording = false;
+	}
+
+} // namespace intern
+
+const char* kindName( const ViolationKind kind )
+{
+	switch( kind ) {
+		case ViolationKind::Allocation: return "allocation";
+		case ViolationKind::Deallocation: return "deallocation";
+		case ViolationKind::Lock: return "lock";
+	}
+	return "";
+}
+
+void setRealtimeThread( const bool value )
+{
+	intern::threadState.realtime = value;
+}
+
+bool isRealtimeThread()
+{
+	return intern::threadState.realtime;
+}
+
+void checkLock( const char* what )
+{
+	intern::record( ViolationKind::Lock, what, 0 );
+}
+
+uint64_t violationCount()
+{
+	return intern::count.load( std::memory_order_relaxed );
+}
+
+uint64_t violationCount( const ViolationKind kind )
+{
+	return intern::kindCount[size_t(kind)].load( std::memory_order_relaxed );
+}
+
+std::vector<Violation> violations()
+{
+	std::vector<Violation> ret;
+	const auto count = std::min<uint64_t>( violationCount(), maxViolations );
+	for( uint64_t i=0; i<count; i++ ) {
+		const auto& slot = intern::slots[i];
+		if( slot.complete.load( std::memory_order_acquire ) ) {
+			ret.push_back( slot.violation );
+		}
+	}
+	return ret;
+}
+
+QString report()
+{
+	QString ret = QString("%1 violation(s) on realtime threads\n").arg( violationCount() );
+	for( const auto& violation : violations() ) {
+		QStringList tags;
+		for( size_t i=0; i<violation.tagCount; i++ ) {
+			tags << violation.tags[i];
+		}
+		ret += QString("%1: %2")
+			.arg( kindName( violation.kind ) )
+			.arg( violation.what );
+		if( violation.size > 0 ) {
+			ret += QString(" (%1 bytes)").arg( violation.size );
+		}
+		if( !tags.isEmpty() ) {
+			ret += QString(" in %1").arg( tags.join(" > ") );
+		}
+		ret += "\n";
+#ifdef __GLIBC__
+		auto symbols = backtrace_symbols( violation.frames.data(), int(violation.frameCount) );
+		if( symbols ) {
+			for( size_t i=0; i<violation.frameCount; i++ ) {
+				ret += QString("    %1\n").arg( symbols[i] );
+			}
+			std::free( symbols );
+		}
+#endif
+	}
+	return ret;
+}
+
+void reset()
+{
+	for( auto& slot : intern::slots ) {
+		slot.complete.store( false, std::memory_order_relaxed );
+	}
+	for( auto& count : intern::kindCount ) {
+		count.store( 0, std::memory_order_relaxed );
+	}
+	intern::count.store( 0, std::memory_order_release );
+}
+
+Realtime::Realtime()
+	: previous( isRealtimeThread() )
+{
+	setRealtimeThread( true );
+}
+
+Realtime::~Realtime()
+{
+	setRealtimeThread( previous );
+}
+
+Allow::Allow()
+{
+	intern::threadState.allowed++;
+}
+
+Allow::~Allow()
+{
+	intern::threadState.allowed--;
+}
+
+Scope::Scope( const char* name )
+{
+	auto& state = intern::threadState;
+	state.tags[state.depth % maxTags] = name;
+	state.depth++;
+}
+
+Scope::~Scope()
+{
+	intern::threadState.depth--;
+}
+
+} // namespace rt_safety
+
+/********************
+ * Interposed libc functions
+*********************/
+
+#ifdef FGE_RT_INTERPOSE
+
+extern "C" {
+	void* __libc_malloc( size_t size );
+	void* __libc_calloc( size_t count, size_t size );
+	void* __libc_realloc( void* ptr, size_t size );
+	void __libc_free( void* ptr );
+	void* __libc_memalign( size_t alignment, size_t size );
+}
+
+namespace rt_safety::intern {
+
+	/* the real lock functions,
+	 * resolved on first use
+	 * (no function local static:
+	 * its guard might lock):
+	 */
+	template <typename Function>
+	Function next( std::atomic<Function>& cache, const char* name ) {
+		auto ret = cache.load( std::memory_order_relaxed );
+		if( !ret ) {
+			ret = reinterpret_cast<Function>( dlsym( RTLD_NEXT, name ) );
+			cache.store( ret, std::memory_order_relaxed );
+		}
+		return ret;
+	}
+
+	using MutexLock = int(*)( pthread_mutex_t* );
+	using RwLock = int(*)( pthread_rwlock_t* );
+
+	std::atomic<MutexLock> mutexLock = nullptr;
+	std::atomic<RwLock> rdLock = nullptr;
+	std::atomic<RwLock> wrLock = nullptr;
+
+} // namespace rt_safety::intern
+
+extern "C" {
+
+void* malloc( size_t size ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Allocation, "malloc", size );
+	return __libc_malloc( size );
+}
+
+void* calloc( size_t count, size_t size ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Allocation, "calloc", count * size );
+	return __libc_calloc( count, size );
+}
+
+void* realloc( void* ptr, size_t size ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Allocation, "realloc", size );
+	return __libc_realloc( ptr, size );
+}
+
+void free( void* ptr ) noexcept
+{
+	if( ptr ) {
+		rt_safety::intern::record( rt_safety::ViolationKind::Deallocation, "free", 0 );
+	}
+	__libc_free( ptr );
+}
+
+void* aligned_alloc( size_t alignment, size_t size ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Allocation, "aligned_alloc", size );
+	return __libc_memalign( alignment, size );
+}
+
+int posix_memalign( void** ptr, size_t alignment, size_t size ) noexcept
+{
+	if( alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 ) {
+		return EINVAL;
+	}
+	rt_safety::intern::record( rt_safety::ViolationKind::Allocation, "posix_memalign", size );
+	auto ret = __libc_memalign( alignment, size );
+	if( !ret ) {
+		return ENOMEM;
+	}
+	*ptr = ret;
+	return 0;
+}
+
+int pthread_mutex_lock( pthread_mutex_t* mutex ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Lock, "pthread_mutex_lock", 0 );
+	return rt_safety::intern::next( rt_safety::intern::mutexLock, "pthread_mutex_lock" )( mutex );
+}
+
+int pthread_rwlock_rdlock( pthread_rwlock_t* lock ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Lock, "pthread_rwlock_rdlock", 0 );
+	return rt_safety::intern::next( rt_safety::intern::rdLock, "pthread_rwlock_rdlock" )( lock );
+}
+
+int pthread_rwlock_wrlock( pthread_rwlock_t* lock ) noexcept
+{
+	rt_safety::intern::record( rt_safety::ViolationKind::Lock, "pthread_rwlock_wrlock", 0 );
+	return rt_safety::intern::next( rt_safety::intern::wrLock, "pthread_rwlock_wrlock" )( lock );
+}
+
+} // extern "C"
+
+#endif
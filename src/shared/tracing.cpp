@@ -0,0 +1,238 @@
+#include "fge/shared/tracing.h"
+#include <QFile>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#ifdef __gnu_linux__
+#include <pthread.h>
+#endif
+
+
+namespace tracing {
+
+namespace intern {
+
+	/* one event slot.
+	 * Guarded by a sequence number
+	 * (odd while being written),
+	 * so the single writer never waits
+	 * and readers skip torn slots.
+	 */
+	struct Slot {
+		std::atomic<uint64_t> sequence = 0;
+		std::atomic<const char*> category = nullptr;
+		std::atomic<const char*> name = nullptr;
+		std::atomic<int64_t> begin = 0;
+		std::atomic<int64_t> end = 0;
+	};
+
+	struct Event {
+		const char* category;
+		const char* name;
+		int64_t begin;
+		int64_t end;
+	};
+
+	struct ThreadBuffer {
+		uint id = 0;
+		std::atomic<const char*> threadName = nullptr;
+		std::atomic<uint64_t> head = 0;
+		std::array<Slot, bufferSize> slots;
+
+		void push( const Event& event ) {
+			const auto index = head.load( std::memory_order_relaxed );
+			auto& slot = slots[index % bufferSize];
+			slot.sequence.store( 2*index+1, std::memory_order_relaxed );
+			std::atomic_thread_fence( std::memory_order_release );
+			slot.category.store( event.category, std::memory_order_relaxed );
+			slot.name.store( event.name, std::memory_order_relaxed );
+			slot.begin.store( event.begin, std::memory_order_relaxed );
+			slot.end.store( event.end, std::memory_order_relaxed );
+			slot.sequence.store( 2*index+2, std::memory_order_release );
+			head.store( index+1, std::memory_order_release );
+		}
+
+		std::vector<Event> events() const {
+			std::vector<Event> ret;
+			const auto end = head.load( std::memory_order_acquire );
+			const auto begin = (end > bufferSize) ? (end - bufferSize) : 0;
+			ret.reserve( end - begin );
+			for( auto index = begin; index < end; index++ ) {
+				const auto& slot = slots[index % bufferSize];
+				const auto sequence = slot.sequence.load( std::memory_order_acquire );
+				if( sequence != 2*index+2 ) {
+					continue;
+				}
+				Event event{
+					.category = slot.category.load( std::memory_order_relaxed ),
+					.name = slot.name.load( std::memory_order_relaxed ),
+					.begin = slot.begin.load( std::memory_order_relaxed ),
+					.end = slot.end.load( std::memory_order_relaxed ),
+				};
+				std::atomic_thread_fence( std::memory_order_acquire );
+				if( slot.sequence.load( std::memory_order_relaxed ) != sequence ) {
+					continue;
+				}
+				ret.push_back( event );
+			}
+			return ret;
+		}
+	};
+
+	struct Registry {
+		std::mutex lock;
+		// buffers outlive their threads:
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+		std::set<std::string> names;
+		std::atomic<int64_t> clearedUntil = 0;
+	};
+
+	Registry& registry() {
+		static Registry value;
+		return value;
+	}
+
+	const char* internLocked( Registry& registry, const std::string& name ) {
+		return registry.names.insert( name ).first->c_str();
+	}
+
+	ThreadBuffer& threadBuffer() {
+		thread_local std::shared_ptr<ThreadBuffer> buffer = []{
+			auto& reg = registry();
+			auto ret = std::make_shared<ThreadBuffer>();
+			std::scoped_lock lock( reg.lock );
+			ret->id = reg.buffers.size() + 1;
+#ifdef __gnu_linux__
+			char name[16] = {};
+			if( pthread_getname_np( pthread_self(), name, sizeof(name) ) == 0 && name[0] != '\0' ) {
+				ret->threadName = internLocked( reg, name );
+			}
+#endif
+			reg.buffers.push_back( ret );
+			return ret;
+		}();
+		return *buffer;
+	}
+
+	void appendEscaped( QByteArray* out, const char* str ) {
+		for( auto c = str; c && *c; c++ ) {
+			switch( *c ) {
+				case '"': out->append( "\\\"" ); break;
+				case '\\': out->append( "\\\\" ); break;
+				case '\n': out->append( "\\n" ); break;
+				default:
+					if( (unsigned char)(*c) < 0x20 ) {
+						out->append( ' ' );
+					}
+					else {
+						out->append( *c );
+					}
+			}
+		}
+	}
+
+} // namespace intern
+
+const char* internString( const QString& name )
+{
+	auto& reg = intern::registry();
+	std::scoped_lock lock( reg.lock );
+	return intern::internLocked( reg, name.toStdString() );
+}
+
+void setThreadName( const char* name )
+{
+	intern::threadBuffer().threadName.store( name, std::memory_order_relaxed );
+}
+
+void record(
+		const char* category,
+		const char* name,
+		const int64_t begin,
+		const int64_t end
+)
+{
+	intern::threadBuffer().push({
+			.category = category,
+			.name = name,
+			.begin = begin,
+			.end = end
+	});
+}
+
+QByteArray chromeTrace()
+{
+	std::vector<std::shared_ptr<intern::ThreadBuffer>> buffers;
+	auto& reg = intern::registry();
+	{
+		std::scoped_lock lock( reg.lock );
+		buffers = reg.buffers;
+	}
+	const auto clearedUntil = reg.clearedUntil.load();
+	QByteArray ret;
+	ret.append( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+	bool first = true;
+	auto separator = [&ret,&first]{
+		if( !first ) {
+			ret.append( ",\n" );
+		}
+		first = false;
+	};
+	for( const auto& buffer : buffers ) {
+		const auto threadName = buffer->threadName.load();
+		if( threadName ) {
+			separator();
+			ret.append( QString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%1,\"args\":{\"name\":\"")
+					.arg( buffer->id ).toUtf8() );
+			intern::appendEscaped( &ret, threadName );
+			ret.append( "\"}}" );
+		}
+		for( const auto& event : buffer->events() ) {
+			if( event.begin < clearedUntil ) {
+				continue;
+			}
+			separator();
+			ret.append( "{\"name\":\"" );
+			intern::appendEscaped( &ret, event.name );
+			ret.append( "\",\"cat\":\"" );
+			intern::appendEscaped( &ret, event.category );
+			// timestamps in microseconds:
+			ret.append( QString("\",\"ph\":\"X\",\"pid\":1,\"tid\":%1,\"ts\":%2,\"dur\":%3}")
+					.arg( buffer->id )
+					.arg( QString::number( double(event.begin) / 1000.0, 'f', 3 ) )
+					.arg( QString::number( double(event.end - event.begin) / 1000.0, 'f', 3 ) )
+					.toUtf8()
+			);
+		}
+	}
+	ret.append( "]}\n" );
+	return ret;
+}
+
+MaybeError writeChromeTrace( const QString& path )
+{
+	if constexpr( !enabled() ) {
+		return "tracing is disabled, rebuild with -DFGE_TRACING=ON";
+	}
+	QFile file( path );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+		return QString("failed to open '%1': %2").arg( path, file.errorString() );
+	}
+	const auto data = chromeTrace();
+	if( file.write( data ) != data.size() ) {
+		return QString("failed to write '%1': %2").arg( path, file.errorString() );
+	}
+	return {};
+}
+
+void clear()
+{
+	// buffers are single writer,
+	// so just hide older events:
+	intern::registry().clearedUntil.store( now() );
+}
+
+} // namespace tracing
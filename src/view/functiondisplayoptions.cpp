@@ -150,8 +150,46 @@ const std::vector<Template> templates = {
 			"state 1 filled"
 		}).join("\n")
 	},
+	{
+		.name = "FIR Lowpass (convolve)",
+		.formula = (QStringList {
+			"// cutoff relative to the samplerate:",
+			"var fc := 0.02;",
+			"if( filled = 0 ) {",
+			"  var N := kernel[];",
+			"  for( var k:=0; k<N; k+=1 ) {",
+			"    var t := k - (N-1)/2;",
+			"    var sinc := if( abs(t) < 0.25, 2*fc, sin(2pi*fc*t)/(pi*t) );",
+			"    kernel[k] := sinc * (0.5 - 0.5*cos(2pi*k/(N-1)));",
+			"  };",
+			"  filled := 1;",
+			"};",
+			"convolve( f0(x), kernel );"
+		}).join("\n"),
+		.data = (QStringList {
+			"state 4096 kernel",
+			"state 1 filled"
+		}).join("\n")
+	},
 	{
 		.name = "FFT",
+		.formula = (QStringList {
+			"if( filled = 0 ) {",
+			"  for( var k:=0; k<buffer[]; k+=1 ) {",
+			"    buffer[k] := f0(k/buffer[]);",
+			"  };",
+			"  fft( buffer, buffer );",
+			"  filled := 1;",
+			"};",
+			"buffer[floor(x)%buffer[]]/buffer[];"
+		}).join("\n"),
+		.data = (QStringList {
+			"state 32768 buffer",
+			"state 1 filled"
+		}).join("\n")
+	},
+	{
+		.name = "FFT (formula)",
 		.formula = (QStringList {
 			"var N := buffer[];",
 			"",
@@ -12,6 +12,7 @@ FunctionView::FunctionView(
     : QWidget(parent)
     , ui(new Ui::FunctionView)
 		, graphView(nullptr)
+		, spectrumView(nullptr)
 		, displayDialog(nullptr)
 		, statusBar(nullptr)
 		, viewData()
@@ -29,6 +30,9 @@ FunctionView::FunctionView(
 	);
 	ui->parametersBtn->setVisible( parameters.size() > 0 );
 	ui->verticalLayout->addWidget( graphView, 1 );
+	spectrumView = new SpectrumView();
+	spectrumView->setVisible( false );
+	ui->verticalLayout->addWidget( spectrumView, 1 );
 	setFocusProxy(
 			ui->formulaEdit
 	);
@@ -72,6 +76,20 @@ FunctionView::FunctionView(
 			);
 		}
 	);
+	connect(
+		ui->spectrumBtn,
+		&QAbstractButton::toggled,
+		[this](bool checked) {
+			spectrumView->setAnalysisEnabled( checked );
+		}
+	);
+	connect(
+		spectrumView,
+		&SpectrumView::settingsChanged,
+		[this](auto settings) {
+			emit spectrumSettingsChanged( settings );
+		}
+	);
 	connect(
 		ui->optionsBtn,
 		&QAbstractButton::clicked,
@@ -207,6 +225,16 @@ void FunctionView::setPlaybackTime( const double value )
 	);
 }
 
+const SpectrumSettings& FunctionView::getSpectrumSettings() const
+{
+	return spectrumView->getSettings();
+}
+
+void FunctionView::addSpectrumFrame( const std::vector<float>& frame )
+{
+	spectrumView->addFrame( frame );
+}
+
 void FunctionView::focusFormula() {
 	ui->formulaEdit-> setFocus();
 }
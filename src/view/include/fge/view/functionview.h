@@ -6,6 +6,7 @@
 #include "fge/view/parametersedit.h"
 #include "fge/view/graphview.h"
 #include "fge/view/functiondisplayoptions.h"
+#include "fge/view/spectrumview.h"
 
 #include <QWidget>
 #include <QStatusBar>
@@ -61,6 +62,9 @@ public:
 	void disablePlaybackPosition();
 	void setPlaybackTime( const double value );
 
+	const SpectrumSettings& getSpectrumSettings() const;
+	void addSpectrumFrame( const std::vector<float>& frame );
+
 	// Actions:
 		void focusFormula();
 		void focusGraph();
@@ -74,11 +78,13 @@ signals:
 			const C value
 	);
   void viewParamsChanged();
+	void spectrumSettingsChanged( SpectrumSettings settings );
 
 private:
 	// UI:
 	Ui::FunctionView *ui;
   GraphView* graphView;
+	SpectrumView* spectrumView;
 	ParametersEdit* parametersDialog;
 	FunctionDisplayOptions* displayDialog;
 	QStatusBar* statusBar;
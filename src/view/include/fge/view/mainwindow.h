@@ -43,6 +43,10 @@ public:
 	void setStatistics(
 			const Statistics& statistics
 	);
+	void setNodeStatistics(
+			const std::vector<NodeStatistics>& statistics,
+			const uint samplerate
+	);
 
 	// Actions:
 		void focusFunction(const uint index);
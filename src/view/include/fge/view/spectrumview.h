@@ -0,0 +1,70 @@
+#ifndef SPECTRUMVIEW_H
+#define SPECTRUMVIEW_H
+
+#include "fge/shared/data.h"
+
+#include <QComboBox>
+#include <QImage>
+#include <QWidget>
+#include <vector>
+
+
+/**
+ * Displays the magnitude spectra (dB)
+ * computed by the analysis stage,
+ * either as the latest spectrum
+ * or as a scrolling spectrogram.
+ */
+class SpectrumPlot : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit SpectrumPlot( QWidget *parent = nullptr );
+
+	void setDisplay( const SpectrumDisplay value );
+	void addFrame( const std::vector<float>& frame );
+	void clear();
+
+protected:
+	void paintEvent( QPaintEvent* event ) override;
+	QSize sizeHint() const override;
+
+private:
+	// logarithmic frequency axis:
+	double binToX( const double bin, const uint binCount, const double width ) const;
+
+private:
+	SpectrumDisplay display = SpectrumDisplay::Spectrum;
+	std::vector<float> lastFrame;
+	QImage spectrogram;
+};
+
+class SpectrumView : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit SpectrumView( QWidget *parent = nullptr );
+
+	const SpectrumSettings& getSettings() const;
+	void setAnalysisEnabled( const bool value );
+
+	void addFrame( const std::vector<float>& frame );
+
+signals:
+	void settingsChanged( SpectrumSettings settings );
+
+private:
+	void updateSettings();
+
+private:
+	SpectrumSettings settings;
+	QComboBox* windowSizeBox;
+	QComboBox* overlapBox;
+	QComboBox* windowTypeBox;
+	QComboBox* displayBox;
+	SpectrumPlot* plot;
+};
+
+#endif // SPECTRUMVIEW_H
@@ -3,6 +3,7 @@
 
 #include <QDialog>
 #include "fge/shared/data.h"
+#include <vector>
 
 namespace Ui {
 class StatisticsDialog;
@@ -19,9 +20,28 @@ public:
 	void set(
 			const Statistics& statistics
 	);
+	void setNodeStatistics(
+			const std::vector<NodeStatistics>& statistics,
+			const uint samplerate
+	);
+
+private:
+	void exportCSV();
+	void exportTrace();
 
 private:
 	Ui::StatisticsDialog *ui;
+	// per function, rates since the previous update:
+	struct NodeRow {
+		double totalNsPerSample = 0;
+		double selfNsPerSample = 0;
+		double selfPercentOfDeadline = 0;
+		double callsPerSample = 0;
+		double graphNsPerSample = 0;
+		size_t stateBytes = 0;
+	};
+	std::vector<NodeStatistics> previous;
+	std::vector<NodeRow> rows;
 };
 
 #endif // STATISTICS_H
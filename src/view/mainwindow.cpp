@@ -185,6 +185,7 @@ void MainWindow::setStatistics(
 )
 {
 	statsDialog->set( statistics );
+	const auto dropouts = statistics.xruns + statistics.underruns;
 	statsDisplay->setText( QString("CPU: %1% < %2%")
 		.arg(
 			QString::number(
@@ -200,9 +201,18 @@ void MainWindow::setStatistics(
 			),
 			2
 		)
+		+ ((dropouts > 0) ? QString(", xruns: %1").arg( dropouts ) : QString())
 	);
 }
 
+void MainWindow::setNodeStatistics(
+		const std::vector<NodeStatistics>& statistics,
+		const uint samplerate
+)
+{
+	statsDialog->setNodeStatistics( statistics, samplerate );
+}
+
 void MainWindow::focusFunction(const uint index)
 {
 	if( index < getFunctionViewCount() ) {
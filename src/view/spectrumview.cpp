@@ -0,0 +1,198 @@
+#include "fge/view/spectrumview.h"
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QPainterPath>
+#include <QVBoxLayout>
+#include <cmath>
+#include <cstring>
+
+
+constexpr float minDB = SpectrumSettings::minDB;
+const uint spectrogramLength = 512;
+
+/*******************
+ * SpectrumPlot
+ ******************/
+
+SpectrumPlot::SpectrumPlot( QWidget *parent )
+	: QWidget( parent )
+{
+	setSizePolicy(
+			QSizePolicy::MinimumExpanding,
+			QSizePolicy::MinimumExpanding
+	);
+	setAutoFillBackground( true );
+}
+
+void SpectrumPlot::setDisplay( const SpectrumDisplay value )
+{
+	display = value;
+	clear();
+}
+
+void SpectrumPlot::addFrame( const std::vector<float>& frame )
+{
+	lastFrame = frame;
+	if( display == SpectrumDisplay::Spectrogram ) {
+		const int height = 256;
+		if( spectrogram.isNull() ) {
+			spectrogram = QImage( spectrogramLength, height, QImage::Format_RGB32 );
+			spectrogram.fill( Qt::black );
+		}
+		// scroll left by one column:
+		for( int y=0; y<height; y++ ) {
+			auto line = reinterpret_cast<QRgb*>( spectrogram.scanLine(y) );
+			std::memmove( line, line+1, (spectrogramLength-1) * sizeof(QRgb) );
+		}
+		// new column, low frequencies at the bottom:
+		const uint binCount = frame.size();
+		for( int y=0; y<height; y++ ) {
+			// inverse of `binToX` (on a logarithmic scale):
+			const double pos = double(height-1-y) / double(height-1);
+			const uint bin = std::min<uint>( binCount-1, uint(std::pow( double(binCount), pos )) );
+			const double level = std::clamp( (frame[bin] - minDB) / -minDB, 0.0f, 1.0f );
+			spectrogram.setPixel(
+					spectrogramLength-1, y,
+					QColor::fromHsvF( 0.7 * (1-level), 1, level ).rgb()
+			);
+		}
+	}
+	update();
+}
+
+void SpectrumPlot::clear()
+{
+	lastFrame.clear();
+	spectrogram = QImage();
+	update();
+}
+
+void SpectrumPlot::paintEvent( QPaintEvent* event )
+{
+	QPainter painter( this );
+	const auto fgColor = palette().color( QPalette::WindowText );
+	if( display == SpectrumDisplay::Spectrogram ) {
+		if( !spectrogram.isNull() ) {
+			painter.drawImage( rect(), spectrogram );
+		}
+		return;
+	}
+	// grid every 20dB:
+	{
+		auto gridColor = fgColor;
+		gridColor.setAlphaF( 0.2 );
+		painter.setPen( gridColor );
+		for( float db = 0; db > minDB; db -= 20 ) {
+			const double y = height() * (db / minDB);
+			painter.drawLine( QPointF(0,y), QPointF(width(),y) );
+		}
+	}
+	if( lastFrame.size() < 2 ) {
+		return;
+	}
+	painter.setRenderHint( QPainter::Antialiasing );
+	painter.setPen( QPen( palette().color( QPalette::Highlight ), 1.5 ) );
+	QPainterPath path;
+	for( uint bin=1; bin<lastFrame.size(); bin++ ) {
+		const QPointF point(
+				binToX( bin, lastFrame.size(), width() ),
+				height() * (lastFrame[bin] / minDB)
+		);
+		if( bin == 1 ) {
+			path.moveTo( point );
+		}
+		else {
+			path.lineTo( point );
+		}
+	}
+	painter.drawPath( path );
+}
+
+QSize SpectrumPlot::sizeHint() const
+{
+	return QSize( 400, 150 );
+}
+
+double SpectrumPlot::binToX( const double bin, const uint binCount, const double width ) const
+{
+	return width * std::log( bin ) / std::log( double(binCount) );
+}
+
+/*******************
+ * SpectrumView
+ ******************/
+
+SpectrumView::SpectrumView( QWidget *parent )
+	: QWidget( parent )
+	, windowSizeBox( new QComboBox() )
+	, overlapBox( new QComboBox() )
+	, windowTypeBox( new QComboBox() )
+	, displayBox( new QComboBox() )
+	, plot( new SpectrumPlot() )
+{
+	for( uint size : { 256, 512, 1024, 2048, 4096, 8192, 16384 } ) {
+		windowSizeBox->addItem( QString::number(size), size );
+	}
+	windowSizeBox->setCurrentText( QString::number( settings.windowSize ) );
+	for( uint overlap : { 1, 2, 4, 8 } ) {
+		overlapBox->addItem( QString("hop 1/%1").arg( overlap ), overlap );
+	}
+	overlapBox->setCurrentIndex( 2 );
+	windowTypeBox->addItem( "rectangular", int(WindowType::Rectangular) );
+	windowTypeBox->addItem( "hann", int(WindowType::Hann) );
+	windowTypeBox->addItem( "hamming", int(WindowType::Hamming) );
+	windowTypeBox->addItem( "blackman", int(WindowType::Blackman) );
+	windowTypeBox->setCurrentIndex( 1 );
+	displayBox->addItem( "spectrum", int(SpectrumDisplay::Spectrum) );
+	displayBox->addItem( "spectrogram", int(SpectrumDisplay::Spectrogram) );
+
+	auto controls = new QHBoxLayout();
+	controls->addWidget( windowSizeBox );
+	controls->addWidget( overlapBox );
+	controls->addWidget( windowTypeBox );
+	controls->addWidget( displayBox );
+	controls->addStretch();
+	auto layout = new QVBoxLayout( this );
+	layout->setContentsMargins( 0, 0, 0, 0 );
+	layout->addLayout( controls, 0 );
+	layout->addWidget( plot, 1 );
+
+	for( auto box : { windowSizeBox, overlapBox, windowTypeBox, displayBox } ) {
+		connect(
+			box,
+			&QComboBox::currentIndexChanged,
+			[this](int) {
+				updateSettings();
+				emit settingsChanged( settings );
+			}
+		);
+	}
+	updateSettings();
+}
+
+const SpectrumSettings& SpectrumView::getSettings() const
+{
+	return settings;
+}
+
+void SpectrumView::setAnalysisEnabled( const bool value )
+{
+	settings.enabled = value;
+	setVisible( value );
+	plot->clear();
+	emit settingsChanged( settings );
+}
+
+void SpectrumView::addFrame( const std::vector<float>& frame )
+{
+	plot->addFrame( frame );
+}
+
+void SpectrumView::updateSettings()
+{
+	settings.windowSize = windowSizeBox->currentData().toUInt();
+	settings.hopSize = std::max<uint>( 1, settings.windowSize / overlapBox->currentData().toUInt() );
+	settings.window = WindowType( windowTypeBox->currentData().toInt() );
+	settings.display = SpectrumDisplay( displayBox->currentData().toInt() );
+	plot->setDisplay( settings.display );
+}
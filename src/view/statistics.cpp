@@ -1,11 +1,49 @@
 #include "fge/view/statistics.h"
 #include "ui_statistics.h"
+#include "fge/shared/tracing.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDebug>
+#include <QTextStream>
+
+
+const QStringList nodeColumns = {
+	"ns/sample",
+	"self ns/sample",
+	"self % deadline",
+	"calls/sample",
+	"graph ns/sample",
+	"state bytes"
+};
 
 StatisticsDialog::StatisticsDialog(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::StatisticsDialog)
 {
     ui->setupUi(this);
+	ui->nodeTable->setColumnCount( nodeColumns.size() );
+	ui->nodeTable->setHorizontalHeaderLabels( nodeColumns );
+	ui->nodeTable->horizontalHeader()->setSectionResizeMode( QHeaderView::Stretch );
+	connect(
+		ui->exportBtn,
+		&QAbstractButton::clicked,
+		[this]() {
+			exportCSV();
+		}
+	);
+	ui->traceBtn->setEnabled( tracing::enabled() );
+	if( !tracing::enabled() ) {
+		ui->traceBtn->setToolTip( "rebuild with -DFGE_TRACING=ON" );
+	}
+	connect(
+		ui->traceBtn,
+		&QAbstractButton::clicked,
+		[this]() {
+			exportTrace();
+		}
+	);
 }
 
 StatisticsDialog::~StatisticsDialog()
@@ -26,4 +64,124 @@ void StatisticsDialog::set(
 			/ statistics.deadline.count()
 	)) + "%" );
 	ui->deadlineLabel->setText( QString::number(statistics.deadline.count()/1000.0) + "ms" );
+	auto percent = [](const double fraction) {
+		return QString::number( fraction * 100, 'f', 1 ) + "%";
+	};
+	ui->latencyLabel->setText(
+			QStringList{
+				percent(statistics.latency.p50),
+				percent(statistics.latency.p90),
+				percent(statistics.latency.p99),
+				percent(statistics.latency.p999)
+			}.join(" / ")
+			+ QString(" (%1 blocks)").arg( statistics.latency.count )
+	);
+	ui->overrunsLabel->setText( QString::number(statistics.overruns) );
+	ui->xrunsLabel->setText( QString::number(statistics.xruns) );
+	ui->underrunsLabel->setText( QString::number(statistics.underruns) );
+	ui->silentBlocksLabel->setText( QString::number(statistics.silentBlocks) );
+	ui->lastUnderrunLabel->setText(
+			statistics.sinceLastUnderrun
+			? QString::number(statistics.sinceLastUnderrun->count()/1000.0, 'f', 1) + "s"
+			: QString("never")
+	);
+}
+
+void StatisticsDialog::setNodeStatistics(
+		const std::vector<NodeStatistics>& statistics,
+		const uint samplerate
+)
+{
+	auto perSample = [](const double value, const uint64_t samples) {
+		return (samples > 0) ? (value / double(samples)) : 0.0;
+	};
+	if( previous.size() != statistics.size() ) {
+		previous = std::vector<NodeStatistics>( statistics.size() );
+	}
+	rows.resize( statistics.size() );
+	const double deadlineNs = (samplerate > 0) ? (1000000000.0 / samplerate) : 0;
+	for( size_t i=0; i<statistics.size(); i++ ) {
+		const auto& current = statistics[i];
+		const auto& last = previous[i];
+		const auto samples = current.audio.samples - last.audio.samples;
+		const auto graphSamples = current.graph.samples - last.graph.samples;
+		// keep the last values if nothing happened:
+		if( samples > 0 ) {
+			rows[i].totalNsPerSample = perSample( current.audio.totalNs - last.audio.totalNs, samples );
+			rows[i].selfNsPerSample = perSample( current.audio.selfNs - last.audio.selfNs, samples );
+			rows[i].callsPerSample = perSample( current.audio.calls - last.audio.calls, samples );
+			rows[i].selfPercentOfDeadline = (deadlineNs > 0)
+				? (rows[i].selfNsPerSample * 100 / deadlineNs)
+				: 0;
+		}
+		if( graphSamples > 0 ) {
+			rows[i].graphNsPerSample = perSample( current.graph.totalNs - last.graph.totalNs, graphSamples );
+		}
+		rows[i].stateBytes = current.stateBytes;
+	}
+	previous = statistics;
+
+	ui->nodeTable->setRowCount( rows.size() );
+	for( size_t i=0; i<rows.size(); i++ ) {
+		const auto& row = rows[i];
+		ui->nodeTable->setVerticalHeaderItem( i, new QTableWidgetItem( QString("f%1").arg(i) ) );
+		const std::vector<QString> values = {
+			QString::number( row.totalNsPerSample, 'f', 1 ),
+			QString::number( row.selfNsPerSample, 'f', 1 ),
+			QString::number( row.selfPercentOfDeadline, 'f', 2 ) + "%",
+			QString::number( row.callsPerSample, 'f', 2 ),
+			QString::number( row.graphNsPerSample, 'f', 1 ),
+			QString::number( row.stateBytes )
+		};
+		for( size_t column=0; column<values.size(); column++ ) {
+			ui->nodeTable->setItem( i, column, new QTableWidgetItem( values[column] ) );
+		}
+	}
+}
+
+void StatisticsDialog::exportCSV()
+{
+	const auto path = QFileDialog::getSaveFileName(
+			this,
+			"Export Statistics",
+			"statistics.csv",
+			"CSV (*.csv)"
+	);
+	if( path.isEmpty() ) {
+		return;
+	}
+	QFile file( path );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+		qWarning() << "failed to write" << path << file.errorString();
+		return;
+	}
+	QTextStream stream( &file );
+	stream << "function," << nodeColumns.join(",") << "\n";
+	for( size_t i=0; i<rows.size(); i++ ) {
+		const auto& row = rows[i];
+		stream << "f" << i
+			<< "," << row.totalNsPerSample
+			<< "," << row.selfNsPerSample
+			<< "," << row.selfPercentOfDeadline
+			<< "," << row.callsPerSample
+			<< "," << row.graphNsPerSample
+			<< "," << row.stateBytes
+			<< "\n";
+	}
+}
+
+void StatisticsDialog::exportTrace()
+{
+	const auto path = QFileDialog::getSaveFileName(
+			this,
+			"Export Trace",
+			"trace.json",
+			"Chrome Trace (*.json)"
+	);
+	if( path.isEmpty() ) {
+		return;
+	}
+	if( auto maybeError = tracing::writeChromeTrace( path ) ) {
+		QMessageBox::warning( this, "Export Trace", maybeError.value() );
+	}
 }
@@ -0,0 +1,569 @@
+#include "fge/model/model.h"
+#include "fge/render/offline_renderer.h"
+#include "fge/shared/config.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <thread>
+
+
+/**
+ * Micro and macro benchmarks of
+ * the model and the audio path.
+ * Results are written as JSON, compare
+ * them against a baseline with
+ * `scripts/compare_benchmarks.py`.
+ *
+ * Unlike `modelbenchmark` this doesn't
+ * use QBENCHMARK, whose results are
+ * not accessible programmatically.
+ */
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+using Nanoseconds = std::chrono::nanoseconds;
+
+/*******************
+ * Runner
+ ******************/
+
+struct BenchmarkResult {
+	QString name;
+	QJsonObject parameters;
+	uint repetitions = 0;
+	double minNs = 0;
+	double medianNs = 0;
+	double meanNs = 0;
+	// items (samples, points...)
+	// processed per repetition:
+	double items = 0;
+};
+
+class BenchmarkRunner
+{
+	public:
+		// measure own time, eg. to exclude setup:
+		using Measurement = std::function<Nanoseconds()>;
+
+		BenchmarkRunner(
+				const uint repetitions,
+				const QRegularExpression& filter
+		)
+			: repetitions( repetitions )
+			, filter( filter )
+		{}
+
+		void run(
+				const QString& name,
+				const QJsonObject& parameters,
+				const double items,
+				Measurement measurement
+		);
+		void runTimed(
+				const QString& name,
+				const QJsonObject& parameters,
+				const double items,
+				std::function<void()> f
+		)
+		{
+			run( name, parameters, items, [f]{
+					const auto t0 = Clock::now();
+					f();
+					return Nanoseconds( Clock::now() - t0 );
+			});
+		}
+
+		QJsonDocument toJson() const;
+
+	private:
+		uint repetitions;
+		QRegularExpression filter;
+		std::vector<BenchmarkResult> results;
+};
+
+void BenchmarkRunner::run(
+		const QString& name,
+		const QJsonObject& parameters,
+		const double items,
+		Measurement measurement
+)
+{
+	QString fullName = name;
+	for( auto it = parameters.begin(); it != parameters.end(); it++ ) {
+		fullName += QString("/%1=%2").arg( it.key(), it.value().toVariant().toString() );
+	}
+	if( !filter.match( fullName ).hasMatch() ) {
+		return;
+	}
+	// warm up:
+	measurement();
+	std::vector<double> times;
+	for( uint i=0; i<repetitions; i++ ) {
+		times.push_back( double(measurement().count()) );
+	}
+	std::sort( times.begin(), times.end() );
+	BenchmarkResult result{
+		.name = fullName,
+		.parameters = parameters,
+		.repetitions = repetitions,
+		.minNs = times.front(),
+		.medianNs = times[times.size()/2],
+		.meanNs = std::accumulate( times.begin(), times.end(), 0.0 ) / times.size(),
+		.items = items
+	};
+	QTextStream( stdout )
+		<< QString("%1 %2 us (min %3 us)")
+			.arg( fullName, -60 )
+			.arg( result.medianNs / 1000.0, 12, 'f', 1 )
+			.arg( result.minNs / 1000.0, 0, 'f', 1 )
+		<< Qt::endl;
+	results.push_back( result );
+}
+
+QJsonDocument BenchmarkRunner::toJson() const
+{
+	QJsonArray array;
+	for( const auto& result : results ) {
+		QJsonObject entry{
+			{ "name", result.name },
+			{ "parameters", result.parameters },
+			{ "repetitions", int(result.repetitions) },
+			{ "min_ns", result.minNs },
+			{ "median_ns", result.medianNs },
+			{ "mean_ns", result.meanNs }
+		};
+		if( result.items > 0 ) {
+			entry["items"] = result.items;
+			entry["items_per_second"] = result.items / (result.medianNs / 1e9);
+		}
+		array.append( entry );
+	}
+	return QJsonDocument( QJsonObject{
+			{ "version", 1 },
+			{ "project", QString( PROJECT_NAME " " PROJECT_VERSION ) },
+			{ "timestamp", QDateTime::currentDateTimeUtc().toString( Qt::ISODate ) },
+			{ "hardware_concurrency", int(std::thread::hardware_concurrency()) },
+			{ "results", array }
+	});
+}
+
+/*******************
+ * Utils
+ ******************/
+
+const QString sine = "sin(2*pi*440*x)";
+
+const QString harmonicSeries =
+	(QStringList {
+		"var N := 10;",
+		"var acc := 0;",
+		"for( var k:=1; k<=N; k+=1 ) {",
+		"  acc += cos( k*440*2pi*x);",
+		"};",
+		"1/N*acc;"
+	}).join("\n");
+
+// f0 = sine, f(i) = mix of f(i-1) and a sine:
+std::vector<QString> chain( const uint depth )
+{
+	std::vector<QString> ret = { sine };
+	for( uint i=1; i<depth; i++ ) {
+		ret.push_back( QString("0.9*f%1(x) + 0.1*sin(2*pi*%2*x)").arg( i-1 ).arg( 110*i ) );
+	}
+	return ret;
+}
+
+MaybeError initModel(
+		Model* model,
+		const std::vector<QString>& formulas,
+		const bool playback = false
+)
+{
+	model->resize( formulas.size() );
+	for( uint i=0; i<formulas.size(); i++ ) {
+		if( auto maybeError = model->set( i, formulas[i], {}, {} ) ) {
+			return maybeError;
+		}
+	}
+	if( playback ) {
+		model->setIsPlaybackEnabled( formulas.size()-1, true );
+	}
+	return {};
+}
+
+void check( const MaybeError& maybeError )
+{
+	if( maybeError ) {
+		qFatal( "%s", qPrintable( maybeError.value() ) );
+	}
+}
+
+/*******************
+ * Benchmarks
+ ******************/
+
+void benchmarkBlockSizes( BenchmarkRunner* runner, const double duration )
+{
+	auto model = modelFactory();
+	check( initModel( model.get(), chain(3), true ) );
+	for( uint blockSize : { 32, 64, 128, 256, 512, 1024, 2048, 4096 } ) {
+		const RenderSettings settings{ .samplerate = 44100, .duration = duration, .blockSize = blockSize };
+		OfflineRenderer renderer( model.get(), settings );
+		runner->run(
+				"audio/valuesToBuffer",
+				{ { "blockSize", int(blockSize) } },
+				duration * settings.samplerate,
+				[&renderer]{
+					auto statistics = renderer.render( [](const std::vector<float>&) -> MaybeError { return {}; } );
+					if( !statistics ) {
+						qFatal( "%s", qPrintable( statistics.error() ) );
+					}
+					return Nanoseconds( statistics->renderTime );
+				}
+		);
+	}
+}
+
+void benchmarkParameterRamps( BenchmarkRunner* runner, const double duration )
+{
+	auto model = modelFactory();
+	model->resize( 1 );
+	check( model->bulkUpdate( 0, Model::Update{
+			.formula = "a*" + sine,
+			.parameters = ParameterBindings{ { "a", C(0.5,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "a", ParameterDescription{ .initial = 0.5, .rampType = FadeType::RampParameter } }
+			},
+			.playbackEnabled = true
+	}));
+	const RenderSettings settings{ .samplerate = 44100, .duration = duration, .blockSize = 256 };
+	OfflineRenderer renderer( model.get(), settings );
+	// change the parameter every `interval` blocks:
+	for( uint interval : { 0, 16, 4, 1 } ) {
+		runner->run(
+				"audio/parameterRamp",
+				{ { "changeEveryBlocks", int(interval) } },
+				duration * settings.samplerate,
+				[&renderer,&model,interval]{
+					uint block = 0;
+					auto statistics = renderer.render( [&](const std::vector<float>&) -> MaybeError {
+							block++;
+							if( interval != 0 && block % interval == 0 ) {
+								model->scheduleSetParameterValues(
+										0,
+										{ { "a", C( (block / interval) % 2 ? 0.25 : 0.75, 0 ) } },
+										[](auto, auto){}
+								);
+							}
+							return {};
+					});
+					if( !statistics ) {
+						qFatal( "%s", qPrintable( statistics.error() ) );
+					}
+					return Nanoseconds( statistics->renderTime );
+				}
+		);
+	}
+}
+
+void benchmarkInterpolation( BenchmarkRunner* runner )
+{
+	const uint resolution = 44100;
+	for( uint interpolation=0; interpolation<=7; interpolation++ ) {
+		auto model = modelFactory( SamplingSettings{
+				.resolution = resolution,
+				.interpolation = interpolation,
+				.periodic = 0
+		});
+		check( initModel( model.get(), { harmonicSeries } ) );
+		runner->runTimed(
+				"graph/interpolation",
+				{ { "interpolation", int(interpolation) } },
+				resolution,
+				[&model]{
+					model->getGraph( 0, {0,1}, resolution );
+				}
+		);
+	}
+}
+
+void benchmarkChainDepth( BenchmarkRunner* runner )
+{
+	const uint resolution = 4410;
+	for( uint depth : { 1, 2, 4, 8, 16, 32 } ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), chain( depth ) ) );
+		runner->runTimed(
+				"graph/chainDepth",
+				{ { "depth", int(depth) } },
+				resolution,
+				[&model,depth]{
+					model->getGraph( depth-1, {0,1}, resolution );
+				}
+		);
+	}
+}
+
+void benchmarkCompile( BenchmarkRunner* runner )
+{
+	const std::vector<std::pair<QString,QString>> formulas = {
+		{ "sine", sine },
+		{ "harmonicSeries", harmonicSeries }
+	};
+	for( const auto& [name, formula] : formulas ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), { formula } ) );
+		runner->runTimed(
+				"model/updateFormulas",
+				{ { "formula", name }, { "dependents", 0 } },
+				0,
+				[&model,formula]{
+					model->set( 0, formula, {}, {} );
+				}
+		);
+	}
+	// recompiling the first entry
+	// recompiles all dependents:
+	for( uint depth : { 8, 32 } ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), chain( depth ) ) );
+		runner->runTimed(
+				"model/updateFormulas",
+				{ { "formula", "sine" }, { "dependents", int(depth-1) } },
+				0,
+				[&model]{
+					model->set( 0, sine, {}, {} );
+				}
+		);
+	}
+}
+
+void benchmarkBufferFill( BenchmarkRunner* runner )
+{
+	for( uint resolution : { 4410, 44100 } ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), { harmonicSeries } ) );
+		bool toggle = false;
+		runner->runTimed(
+				"model/bufferFill",
+				{ { "resolution", int(resolution) } },
+				resolution,
+				[&model,&toggle,resolution]{
+					// change settings to force a refill:
+					toggle = !toggle;
+					model->setSamplingSettings( 0, SamplingSettings{
+							.resolution = resolution,
+							.interpolation = toggle ? 1u : 2u,
+							.periodic = 1,
+							.buffered = true
+					});
+				}
+		);
+	}
+}
+
+/* partials summed by a formula loop
+ * vs. the `harmonics` builtin:
+ */
+void benchmarkHarmonics( BenchmarkRunner* runner )
+{
+	const uint resolution = 4410;
+	for( uint partials : { 10, 100, 500 } ) {
+		const std::vector<std::pair<QString,QString>> formulas = {
+			{ "loop",
+				(QStringList {
+					"var acc := 0;",
+					QString("for( var k:=1; k<=%1; k+=1 ) {").arg( partials ),
+					"  acc += cos( k*440*2pi*x);",
+					"};",
+					QString("1/%1*acc;").arg( partials )
+				}).join("\n")
+			},
+			{ "builtin",
+				QString("var a[%1] := { %2 }; real( harmonics( 440*x, a ) )")
+					.arg( partials )
+					.arg( QStringList( partials, QString("1/%1").arg( partials ) ).join(", ") )
+			}
+		};
+		for( const auto& [name, formula] : formulas ) {
+			auto model = modelFactory();
+			check( initModel( model.get(), { formula } ) );
+			runner->runTimed(
+					"graph/harmonics",
+					{ { "partials", int(partials) }, { "implementation", name } },
+					resolution,
+					[&model]{
+						model->getGraph( 0, {0,1}, resolution );
+					}
+			);
+		}
+	}
+}
+
+/* sine by `cos` vs. by `phasor`
+ * (recurrence for equidistant x):
+ */
+void benchmarkPhasor( BenchmarkRunner* runner )
+{
+	const uint resolution = 44100;
+	const std::vector<std::pair<QString,QString>> formulas = {
+		{ "cos", "cos( 2pi*440*x )" },
+		{ "phasor", "real( phasor( 2pi*440*x, s ) )" }
+	};
+	for( const auto& [name, formula] : formulas ) {
+		auto model = modelFactory();
+		model->resize( 1 );
+		check( model->set( 0, formula, {}, { { "s", StateDescription{ .size = 4 } } } ) );
+		runner->runTimed(
+				"graph/sine",
+				{ { "implementation", name } },
+				resolution,
+				[&model]{
+					model->getGraph( 0, {0,1}, resolution );
+				}
+		);
+	}
+}
+
+/* arithmetic on (mostly) real values,
+ * compare runs before/after changes
+ * to the complex number adaptor:
+ */
+void benchmarkArithmetic( BenchmarkRunner* runner )
+{
+	const uint resolution = 44100;
+	const std::vector<std::pair<QString,QString>> formulas = {
+		{ "pow", "x^2 - 3*x^3" },
+		{ "mulDiv", "(x*3.5 + x/7) * x" },
+		{ "transcendental", "sqrt(x) + exp(-x) * sin(x)" },
+		{ "mtof", "mtof( 60 + 12*x )" }
+	};
+	for( const auto& [name, formula] : formulas ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), { formula } ) );
+		runner->runTimed(
+				"graph/arithmetic",
+				{ { "formula", name } },
+				resolution,
+				[&model]{
+					model->getGraph( 0, {0,1}, resolution );
+				}
+		);
+	}
+}
+
+/* getGraph latency while another
+ * thread renders audio as fast as possible
+ * (compare with `rendering=0`):
+ */
+void benchmarkConcurrentRead( BenchmarkRunner* runner )
+{
+	const uint resolution = 4410;
+	const uint samplerate = 44100;
+	for( bool rendering : { false, true } ) {
+		auto model = modelFactory();
+		check( initModel( model.get(), chain( 4 ), true ) );
+		std::atomic<bool> stop = false;
+		std::atomic<uint64_t> blocks = 0;
+		std::thread audioThread;
+		if( rendering ) {
+			audioThread = std::thread([&]{
+					std::vector<float> buffer( 256 );
+					PlaybackPosition position = 0;
+					while( !stop ) {
+						model->valuesToBuffer( &buffer, position, samplerate );
+						position += buffer.size();
+						model->betweenAudio( position, samplerate );
+						blocks++;
+					}
+			});
+			model->setAudioSchedulingEnabled( true );
+		}
+		const auto blocksBefore = blocks.load();
+		const auto t0 = Clock::now();
+		runner->runTimed(
+				"concurrency/graphWhileRendering",
+				{ { "rendering", rendering ? 1 : 0 } },
+				resolution,
+				[&model]{
+					model->getGraph( 3, {0,1}, resolution );
+				}
+		);
+		if( rendering ) {
+			const auto seconds = std::chrono::duration<double>( Clock::now() - t0 ).count();
+			QTextStream( stdout )
+				<< QString("  audio blocks rendered meanwhile: %1/s")
+					.arg( double(blocks - blocksBefore) / seconds, 0, 'f', 0 )
+				<< Qt::endl;
+			model->setAudioSchedulingEnabled( false );
+			stop = true;
+			audioThread.join();
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName( "benchmarksuite" );
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription( "Model and audio benchmarks, JSON output." );
+	parser.addHelpOption();
+	parser.addOptions({
+			{ {"o", "output"}, "write results as JSON.", "file" },
+			{ {"f", "filter"}, "only run benchmarks matching regex.", "regex", "." },
+			{ {"r", "repetitions"}, "repetitions per benchmark.", "n", "10" },
+			{ "quick", "shorter renders and fewer repetitions (for ctest)." },
+	});
+	parser.process( app );
+
+	const bool quick = parser.isSet( "quick" );
+	bool ok = false;
+	const uint repetitions = quick ? 2 : parser.value( "repetitions" ).toUInt( &ok );
+	if( !quick && (!ok || repetitions == 0) ) {
+		qCritical() << "invalid repetitions";
+		return 1;
+	}
+	const QRegularExpression filter( parser.value( "filter" ) );
+	if( !filter.isValid() ) {
+		qCritical() << "invalid filter:" << filter.errorString();
+		return 1;
+	}
+	const double renderDuration = quick ? 0.1 : 1.0;
+
+	BenchmarkRunner runner( repetitions, filter );
+	benchmarkBlockSizes( &runner, renderDuration );
+	benchmarkParameterRamps( &runner, renderDuration );
+	benchmarkInterpolation( &runner );
+	benchmarkChainDepth( &runner );
+	benchmarkCompile( &runner );
+	benchmarkBufferFill( &runner );
+	benchmarkHarmonics( &runner );
+	benchmarkPhasor( &runner );
+	benchmarkArithmetic( &runner );
+	benchmarkConcurrentRead( &runner );
+
+	if( parser.isSet( "output" ) ) {
+		QFile file( parser.value( "output" ) );
+		if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+			qCritical().noquote() << "failed to open output:" << file.errorString();
+			return 1;
+		}
+		file.write( runner.toJson().toJson() );
+	}
+	return 0;
+}
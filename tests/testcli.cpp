@@ -0,0 +1,124 @@
+#include "testcli.h"
+#include "chain_file.h"
+#include "fge/shared/parameter_utils.h"
+#include <qtestcase.h>
+
+QTEST_MAIN(TestCli)
+#include "testcli.moc"
+
+
+void TestCli::testParseChain()
+{
+	const auto maybeChain = parseChain( QByteArray(R"json({
+		"functions": [
+			{
+				"formula": "sin(2*pi*freq*x)",
+				"data": "parameter 1 freq 440 20 20000",
+				"parameters": { "freq": 220 },
+				"playback": true,
+				"playbackSpeed": 0.5,
+				"sampling": { "resolution": 100, "buffered": true }
+			},
+			{ "formula": "x" }
+		]
+	})json") );
+	QVERIFY2( maybeChain, qPrintable( maybeChain ? QString() : maybeChain.error() ) );
+	const auto& chain = maybeChain.value();
+	QCOMPARE( chain.size(), size_t(2) );
+	QCOMPARE( chain[0].formula, QString("sin(2*pi*freq*x)") );
+	QCOMPARE( chain[0].dataDescription, QString("parameter 1 freq 440 20 20000") );
+	QVERIFY( chain[0].parameters == ParameterBindings({ { "freq", C(220,0) } }) );
+	QVERIFY( chain[0].playbackEnabled );
+	QCOMPARE( chain[0].playbackSettings.playbackSpeed, 0.5 );
+	QVERIFY( chain[0].samplingSettings );
+	QCOMPARE( chain[0].samplingSettings->resolution, 100u );
+	QVERIFY( chain[0].samplingSettings->buffered );
+	// missing fields use the defaults:
+	QCOMPARE( chain[0].samplingSettings->interpolation, no_optimization_settings.interpolation );
+	QCOMPARE( chain[1].formula, QString("x") );
+	QVERIFY( chain[1].dataDescription.isEmpty() );
+	QVERIFY( chain[1].parameters.empty() );
+	QVERIFY( !chain[1].playbackEnabled );
+	QCOMPARE( chain[1].playbackSettings.playbackSpeed, 1.0 );
+	QVERIFY( !chain[1].samplingSettings );
+}
+
+void TestCli::testParseChainErrors_data()
+{
+	QTest::addColumn<QByteArray>("json");
+
+	QTest::newRow("invalid json")
+		<< QByteArray(R"json({ "functions": [ )json");
+	QTest::newRow("no functions")
+		<< QByteArray(R"json({ "function": [] })json");
+	QTest::newRow("entry not an object")
+		<< QByteArray(R"json({ "functions": [ { "formula": "x" }, 1 ] })json");
+	QTest::newRow("missing formula")
+		<< QByteArray(R"json({ "functions": [ { "data": "state 1 s" } ] })json");
+	QTest::newRow("parameter not a number")
+		<< QByteArray(R"json({ "functions": [ { "formula": "x", "parameters": { "a": "1" } } ] })json");
+}
+
+void TestCli::testParseChainErrors()
+{
+	QFETCH(QByteArray, json);
+	const auto maybeChain = parseChain( json );
+	QVERIFY( !maybeChain );
+	QVERIFY( !maybeChain.error().isEmpty() );
+}
+
+void TestCli::testApplyChain()
+{
+	// canonical form, as printed by
+	// `functionDataDescriptionToString`:
+	const QString dataDescription =
+		"parameter 1 freq 440 20 20000 1 ramp=parameter\n"
+		"state 4 buf\n"
+		"delay 8 d\n";
+	const Chain chain = {
+		{
+			.formula = "buf[0] := x; freq * x",
+			.dataDescription = dataDescription,
+			.parameters = { { "freq", C(220,0) } },
+			.playbackEnabled = true,
+			.playbackSettings = {},
+			.samplingSettings = {}
+		},
+		{
+			.formula = "2 * x",
+			.dataDescription = "",
+			.parameters = {},
+			.playbackEnabled = false,
+			.playbackSettings = {},
+			.samplingSettings = {}
+		}
+	};
+	auto model = modelFactory();
+	const auto maybeError = applyChain( model.get(), chain );
+	QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	QCOMPARE( model->size(), 2u );
+	QVERIFY( !model->getError(0) );
+	QVERIFY( !model->getError(1) );
+	QVERIFY( model->getIsPlaybackEnabled(0) );
+	QVERIFY( !model->getIsPlaybackEnabled(1) );
+	const auto info = model->get(0);
+	QCOMPARE( info.formula, chain[0].formula );
+	// the initial value is overwritten:
+	QVERIFY( info.parameters == ParameterBindings({ { "freq", C(220,0) } }) );
+	QCOMPARE( info.parameterDescriptions.at("freq").initial, 440.0 );
+	QCOMPARE( info.stateDescriptions.size(), size_t(2) );
+	QCOMPARE( info.stateDescriptions.at("buf").size, 4u );
+	QVERIFY( info.stateDescriptions.at("d").kind == StateKind::Delay );
+	// round-trip:
+	QCOMPARE(
+			functionDataDescriptionToString( FunctionDataDescription{
+				.parameterDescriptions = info.parameterDescriptions,
+				.stateDescriptions = info.stateDescriptions
+			}),
+			dataDescription
+	);
+	// unknown parameters are rejected:
+	Chain invalid = chain;
+	invalid[1].parameters = { { "freq", C(1,0) } };
+	QVERIFY( applyChain( model.get(), invalid ) );
+}
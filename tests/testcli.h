@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QTest>
+
+class TestCli: public QObject
+{
+	Q_OBJECT
+private slots:
+	void testParseChain();
+	void testParseChainErrors_data();
+	void testParseChainErrors();
+	void testApplyChain();
+};
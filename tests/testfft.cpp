@@ -0,0 +1,167 @@
+#include <qtestcase.h>
+#include "testfft.h"
+#include "fge/model/fft.h"
+#include "fge/model/stft.h"
+#include "fge/model/convolution.h"
+#include <numbers>
+
+QTEST_MAIN(TestFFT)
+#include "testfft.moc"
+
+
+// UTILS:
+
+using value_t = FFTPlan::value_t;
+
+std::vector<value_t> testSignal( const size_t size )
+{
+	std::vector<value_t> ret( size );
+	for( size_t i=0; i<size; i++ ) {
+		ret[i] = value_t( std::sin( T(i) * 0.37 ) + 0.1 * T(i), std::cos( T(i) * 1.3 ) );
+	}
+	return ret;
+}
+
+std::vector<value_t> naiveDFT( const std::vector<value_t>& x )
+{
+	const auto n = x.size();
+	std::vector<value_t> ret( n );
+	for( size_t k=0; k<n; k++ ) {
+		for( size_t j=0; j<n; j++ ) {
+			ret[k] += x[j] * std::polar( T(1), -2 * std::numbers::pi * T((j*k) % n) / T(n) );
+		}
+	}
+	return ret;
+}
+
+T maxDiff( const std::vector<value_t>& a, const std::vector<value_t>& b )
+{
+	T ret = 0;
+	for( size_t i=0; i<a.size(); i++ ) {
+		ret = std::max( ret, std::abs( a[i] - b[i] ) );
+	}
+	return ret;
+}
+
+void addSizes()
+{
+	QTest::addColumn<size_t>("size");
+	for( size_t size : { 1, 2, 3, 8, 12, 64, 100, 1024, 1000 } ) {
+		QTest::newRow( QString::number(size).toStdString().c_str() ) << size;
+	}
+}
+
+/* TEST */
+
+void TestFFT::testForward_data() {
+	addSizes();
+}
+
+void TestFFT::testForward() {
+	QFETCH(size_t, size);
+	const auto x = testSignal( size );
+	auto y = x;
+	fftPlan( size ).forward( y.data() );
+	const auto expected = naiveDFT( x );
+	QVERIFY2(
+			maxDiff( y, expected ) < 1e-9 * T(size),
+			QString("max diff: %1").arg( maxDiff( y, expected ) ).toStdString().c_str()
+	);
+}
+
+void TestFFT::testRoundTrip_data() {
+	addSizes();
+}
+
+void TestFFT::testRoundTrip() {
+	QFETCH(size_t, size);
+	const auto x = testSignal( size );
+	auto y = x;
+	auto& plan = fftPlan( size );
+	plan.forward( y.data() );
+	plan.inverse( y.data() );
+	QVERIFY( maxDiff( y, x ) < 1e-12 * T(size) );
+}
+
+void TestFFT::testPadding() {
+	// constant input zero padded to 8
+	// is a sampled sinc:
+	std::vector<C> in( 4, C(1,0) );
+	std::vector<C> out( 8 );
+	fft( out.data(), out.size(), in.data(), in.size() );
+	QVERIFY( std::abs( out[0].c_ - value_t(4) ) < 1e-12 );
+	QVERIFY( std::abs( out[2].c_ ) < 1e-12 );
+	QVERIFY( std::abs( out[4].c_ ) < 1e-12 );
+	// in place via the same buffer:
+	ifft( out.data(), out.size(), out.data(), out.size() );
+	for( size_t i=0; i<out.size(); i++ ) {
+		QVERIFY( std::abs( out[i].c_ - value_t( i<4 ? 1 : 0 ) ) < 1e-12 );
+	}
+}
+
+void TestFFT::testSTFT() {
+	const SpectrumSettings settings{
+		.enabled = true,
+		.windowSize = 256,
+		.hopSize = 64,
+		.window = WindowType::Hann
+	};
+	STFT stft( settings );
+	QCOMPARE( stft.binCount(), 129u );
+	// sinusoid of amplitude 1 centered on bin 16:
+	std::vector<float> samples( 1000 );
+	for( size_t i=0; i<samples.size(); i++ ) {
+		samples[i] = std::sin( 2 * std::numbers::pi * 16 * T(i) / 256 );
+	}
+	std::vector<STFT::Frame> frames;
+	// feed in odd chunk sizes:
+	for( size_t pos=0; pos<samples.size(); pos+=37 ) {
+		const auto count = std::min<size_t>( 37, samples.size() - pos );
+		stft.process( samples.data() + pos, count, [&frames](const auto& frame) {
+				frames.push_back( frame );
+		});
+	}
+	// first frame after 256 samples, then every 64:
+	QCOMPARE( frames.size(), size_t(1 + (1000-256)/64) );
+	for( const auto& frame : frames ) {
+		QCOMPARE( frame.size(), size_t(stft.binCount()) );
+		QVERIFY( std::abs( frame[16] ) < 0.1 );
+		QVERIFY( frame[40] < -60 );
+		QVERIFY( frame[40] >= STFT::minDB );
+	}
+}
+
+void TestFFT::testPartitionedConvolution() {
+	const size_t blockSize = 64;
+	for( size_t kernelSize : { 1, 5, 64, 300, 1000 } ) {
+		std::vector<C> kernel( kernelSize );
+		for( size_t i=0; i<kernelSize; i++ ) {
+			kernel[i] = C( std::sin( T(i) * 0.3 ), 0.1 * std::cos( T(i) * 0.7 ) );
+		}
+		std::vector<C> input( 2000 );
+		for( size_t i=0; i<input.size(); i++ ) {
+			input[i] = C( std::cos( T(i) * 0.11 ) + 0.3 * T((i*7) % 5), 0 );
+		}
+		PartitionedConvolution convolution( blockSize );
+		convolution.setKernel( kernel.data(), kernel.size() );
+		QCOMPARE( convolution.latency(), blockSize );
+		T maxError = 0;
+		for( size_t n=0; n<input.size(); n++ ) {
+			const auto output = convolution.process( input[n] );
+			if( n < blockSize ) {
+				continue;
+			}
+			// direct convolution, delayed by the latency:
+			const size_t m = n - blockSize;
+			value_t expected = 0;
+			for( size_t k=0; k<kernelSize && k<=m; k++ ) {
+				expected += kernel[k].c_ * input[m-k].c_;
+			}
+			maxError = std::max( maxError, std::abs( output.c_ - expected ) );
+		}
+		QVERIFY2(
+				maxError < 1e-9,
+				QString("kernel size %1: max error %2").arg( kernelSize ).arg( maxError ).toStdString().c_str()
+		);
+	}
+}
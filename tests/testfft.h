@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QTest>
+
+class TestFFT: public QObject
+{
+	Q_OBJECT
+private slots:
+	void testForward_data();
+	void testForward();
+	void testRoundTrip_data();
+	void testRoundTrip();
+	void testPadding();
+	void testSTFT();
+	void testPartitionedConvolution();
+};
@@ -4,6 +4,10 @@
 #include "testfunction.h"
 #include "testutils.h"
 #include "fge/model/function.h"
+#include "fge/model/function_collection_impl.h"
+#include "fge/model/oscillators.h"
+#include "fge/model/convolution.h"
+#include "fge/model/fft.h"
 
 QTEST_MAIN(TestFormulaFunction)
 #include "testfunction.moc"
@@ -155,6 +159,301 @@ void TestFormulaFunction::testEvalWithParameters()
 	);
 }
 
+void TestFormulaFunction::testParameterHandles()
+{
+	auto errOrValue = formulaFunctionFactory(
+			"a * x + b",
+			{ {"b", { C(1,0)} }, {"a", { C(2,0)} } },
+			{},
+			{}
+	);
+	assert( errOrValue );
+	auto function = errOrValue.value();
+	// sorted by name:
+	QCOMPARE( function->getParameterHandle( "a" ), std::optional<ParameterHandle>( 0 ) );
+	QCOMPARE( function->getParameterHandle( "b" ), std::optional<ParameterHandle>( 1 ) );
+	QVERIFY( !function->getParameterHandle( "c" ) );
+	QVERIFY( function->getParameter( 1 ) == C(1,0) );
+	function->setParameter( 0, C(3,0) );
+	QVERIFY( function->getParameters().at("a") == C(3,0) );
+	checkFunction(
+			function.get(),
+			[](auto x){ return C(3 * x + 1,0); },
+			{-3, 3},
+			8
+	);
+	// ignored:
+	function->setParameter( 2, C(5,0) );
+	QVERIFY( function->getParameters().size() == 2 );
+}
+
+void TestFormulaFunction::testStateSnapshot()
+{
+	auto errOrValue = formulaFunctionFactory(
+			"s := s + 1; v[0] := v[0] + x; s",
+			{},
+			{ { "s", StateDescription{ .size = 1 } }, { "v", StateDescription{ .size = 4 } } },
+			{}
+	);
+	QVERIFY( errOrValue );
+	auto function = errOrValue.value();
+	// 5 values, rounded to cache lines:
+	QCOMPARE( function->getStateBytes(), size_t(StateArena::alignment * 2) );
+	QVERIFY( function->get( C(0,0) ) == C(1,0) );
+	QVERIFY( function->get( C(0,0) ) == C(2,0) );
+	StateArena::Snapshot snapshot;
+	function->saveState( &snapshot );
+	QVERIFY( function->get( C(0,0) ) == C(3,0) );
+	function->restoreState( snapshot );
+	QVERIFY( function->get( C(0,0) ) == C(3,0) );
+	function->resetState();
+	QVERIFY( function->get( C(0,0) ) == C(1,0) );
+}
+
+void TestFormulaFunction::testFilters()
+{
+	// dc input passes the lowpasses,
+	// a biquad section with b0=1 is the identity:
+	auto errOrValue = formulaFunctionFactory(
+			"var c[5] := {1,0,0,0,0}; "
+			"complex( onepole(1, 0.1, a), real(svf(1, 0.1, 0.7, b)) ) + biquad(x, c, d)",
+			{},
+			{
+				{ "a", StateDescription{ .size = 3 } },
+				{ "b", StateDescription{ .size = 5 } },
+				{ "d", StateDescription{ .size = 8 } }
+			},
+			{ symbols() }
+	);
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	C y;
+	for( uint i=0; i<1000; i++ ) {
+		y = function->get( C(0,0) );
+	}
+	QVERIFY( std::abs( y.c_.real() - 1 ) < 1e-6 );
+	QVERIFY( std::abs( y.c_.imag() - 1 ) < 1e-6 );
+	QVERIFY( std::abs( function->get( C(2,0) ).c_.real() - 3 ) < 1e-6 );
+	// filter memory is function state:
+	function->resetState();
+	// one step of the onepole:
+	QVERIFY( std::abs( function->get( C(0,0) ).c_.real() - (1 - std::exp( -0.2 * std::acos(-1) )) ) < 1e-6 );
+}
+
+void TestFormulaFunction::testDelayLine()
+{
+	// inputs 1..20, read before writing 20.
+	// size 5 is rounded up to 8 samples:
+	const std::vector<std::pair<T,T>> delayToExpected = {
+		// between the inputs 2 and 3 writes ago:
+		{ 2.5, 17.5 },
+		{ 1, 19 },
+		// clamped to the minimum delay:
+		{ 0.25, 19 },
+		{ 0, 19 },
+		{ -3, 19 },
+		{ 7.5, 12.5 },
+		// the oldest sample:
+		{ 8, 12 },
+		// clamped to the capacity:
+		{ 8.5, 12 },
+		{ 100, 12 },
+	};
+	for( const auto& [delay, expected] : delayToExpected ) {
+		auto errOrValue = formulaFunctionFactory(
+				QString( "var y := delay_read(%1, d); delay_write(x, d); y" ).arg( delay ),
+				{},
+				{ { "d", StateDescription{ .size = 5, .kind = StateKind::Delay } } },
+				{ symbols() }
+		);
+		QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+		auto function = errOrValue.value();
+		QCOMPARE( function->getStateBytes(), size_t(StateArena::alignment * 3) );
+		C y;
+		for( uint i=1; i<=20; i++ ) {
+			y = function->get( C(i,0) );
+		}
+		QVERIFY2(
+				y == C(expected,0),
+				qPrintable( QString( "delay %1: %2 != %3 (expected)" ).arg( delay ).arg( to_qstring( y ) ).arg( expected ) )
+		);
+	}
+}
+
+void TestFormulaFunction::testHarmonics()
+{
+	// 7 partials, incomplete last chain:
+	auto errOrValue = formulaFunctionFactory(
+			"var a[7] := {1, 0.5, 0.25, 0, 2, i, -1}; harmonics(3*x, a)",
+			{},
+			{},
+			{ symbols() }
+	);
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	const std::vector<std::complex<T>> amps = { 1, 0.5, 0.25, 0, 2, {0,1}, -1 };
+	for( int i=-64; i<=64; i++ ) {
+		const T x = T(i) / 21;
+		std::complex<T> expected = 0;
+		for( uint k=1; k<=amps.size(); k++ ) {
+			expected += amps[k-1] * std::polar( T(1), 2 * std::acos(T(-1)) * k * 3 * x );
+		}
+		QVERIFY( std::abs( function->get( C(x,0) ).c_ - expected ) < 1e-9 );
+	}
+}
+
+void TestFormulaFunction::testPhasor()
+{
+	auto errOrValue = formulaFunctionFactory(
+			"phasor(2pi*440*x + 1, s)",
+			{},
+			{ { "s", StateDescription{ .size = phasorStateSize } } },
+			{ symbols() }
+	);
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	const T pi = std::acos(T(-1));
+	// equidistant, then jumping back:
+	std::vector<T> xs;
+	for( uint i=0; i<1000; i++ ) {
+		xs.push_back( T(i) / 44100 );
+	}
+	for( uint i=0; i<100; i++ ) {
+		xs.push_back( T(i) / 4410 );
+	}
+	for( const auto x : xs ) {
+		const auto expected = std::polar( T(1), 2*pi*440*x + 1 );
+		QVERIFY( std::abs( function->get( C(x,0) ).c_ - expected ) < 1e-9 );
+	}
+}
+
+void TestFormulaFunction::testRandom()
+{
+	const auto factory = [](const uint64_t seed) {
+		auto errOrValue = formulaFunctionFactory(
+				"rnd_fill(v); complex( rnd(), v[3] )",
+				{},
+				{ { "v", StateDescription{ .size = 4 } } },
+				{}
+		);
+		if( errOrValue ) {
+			errOrValue.value()->setSeed( seed );
+		}
+		return errOrValue;
+	};
+	auto errOrValue = factory( 0 );
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	std::vector<C> values;
+	for( uint i=0; i<100; i++ ) {
+		const auto value = function->get( C(0,0) );
+		QVERIFY( value.c_.real() >= 0 && value.c_.real() < 1 );
+		QVERIFY( value.c_.imag() >= 0 && value.c_.imag() < 1 );
+		values.push_back( value );
+	}
+	QVERIFY( values[0] != values[1] );
+	// reproducible, per formula and seed:
+	auto errOrOther = factory( 0 );
+	QVERIFY2( errOrOther, qPrintable( errOrOther ? QString() : errOrOther.error() ) );
+	QVERIFY( errOrOther.value()->get( C(0,0) ) == values[0] );
+	function->resetState();
+	QVERIFY( function->get( C(0,0) ) == values[0] );
+	// same formula, other seed (e.g. slot):
+	auto errOrReseeded = factory( 1 );
+	QVERIFY2( errOrReseeded, qPrintable( errOrReseeded ? QString() : errOrReseeded.error() ) );
+	QVERIFY( errOrReseeded.value()->get( C(0,0) ) != values[0] );
+	// the seed survives a reset:
+	function->setSeed( 1 );
+	function->resetState();
+	QVERIFY( function->get( C(0,0) ) != values[0] );
+}
+
+void TestFormulaFunction::testConvolve()
+{
+	QVERIFY(( convolveKernelNames( "convolve( f0(x, 2), k1 ) + convolve(x,k2)+myconvolve(x, k3)" ) == std::vector<QString>{ "k1", "k2" } ));
+	auto errOrValue = formulaFunctionFactory(
+			"if( filled = 0 ) { k[0] := 1; k[2] := 0.5; filled := 1; }; convolve(x, k)",
+			{},
+			{ { "k", StateDescription{ .size = 4 } }, { "filled", StateDescription{ .size = 1 } } },
+			{ symbols() }
+	);
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	// delayed by the latency (128):
+	for( int i=0; i<400; i++ ) {
+		const T expected =
+			(i >= 128 ? T(i-128) : 0)
+			+ (i >= 130 ? 0.5 * T(i-130) : 0);
+		const auto y = function->get( C(i,0) );
+		QVERIFY2(
+				std::abs( y.c_ - std::complex<T>(expected) ) < 1e-6,
+				qPrintable( QString( "sample %1: %2 != %3 (expected)" ).arg( i ).arg( to_qstring( y ) ).arg( expected ) )
+		);
+	}
+	// not a state vector, not prepared:
+	auto errOrLocal = formulaFunctionFactory(
+			"var k[2] := {1, 1}; convolve(x, k)",
+			{},
+			{},
+			{ symbols() }
+	);
+	QVERIFY2( errOrLocal, qPrintable( errOrLocal ? QString() : errOrLocal.error() ) );
+	for( int i=0; i<300; i++ ) {
+		QVERIFY( errOrLocal.value()->get( C(1,0) ) == C(0,0) );
+	}
+}
+
+void TestFormulaFunction::testFFT()
+{
+	QVERIFY(( fftOutputNames( "fft( X, v ); ifft(y,X); myfft(z, v); fft( w[0:3], v )" ) == std::vector<QString>{ "X", "w[0:3]", "y" } ));
+	QCOMPARE( localVectorSize( "var v[8] := {1}; var vv [ 6 ]", "vv" ).value_or( 0 ), size_t(6) );
+	QVERIFY( !localVectorSize( "var v[2*4]", "v" ) );
+	// power of 2 and bluestein sizes,
+	// into local and state vectors:
+	auto errOrValue = formulaFunctionFactory(
+			"var v[6] := {1, 2, 3, 4, 5, 6}; "
+			"var X[8]; var y[8]; "
+			"fft(X, v); ifft(y, X); "
+			"fft(S, v); ifft(S, S); "
+			"complex( y[2] + 10*y[6], S[5] + real(X[0]) )",
+			{},
+			{ { "S", StateDescription{ .size = 6 } } },
+			{ symbols() }
+	);
+	QVERIFY2( errOrValue, qPrintable( errOrValue ? QString() : errOrValue.error() ) );
+	auto function = errOrValue.value();
+	// zero padded to 8 (y[6] == 0),
+	// X[0] is the sum of v:
+	for( uint i=0; i<2; i++ ) {
+		const auto y = function->get( C(0,0) );
+		QVERIFY2(
+				std::abs( y.c_ - std::complex<T>( 3, 6 + 21 ) ) < 1e-9,
+				qPrintable( to_qstring( y ) )
+		);
+	}
+}
+
+void TestFormulaFunction::testRealFastPaths()
+{
+	const std::vector<std::pair<QString,C>> expected = {
+		// exact for integer exponents:
+		{ "(-2)^3", C(-8,0) },
+		{ "2^-2", C(0.25,0) },
+		{ "i^2", C(-1,0) },
+		{ "(1+2i)/2", C(0.5,1) },
+		{ "mtof(81)", C(880,0) },
+		// complex results stay complex:
+		{ "sqrt(-4)", C(0,2) },
+		{ "(1+2i)/(2i)", C(1,-0.5) }
+	};
+	for( const auto& [formula, value] : expected ) {
+		auto errOrValue = formulaFunctionFactory( formula, {}, {}, { symbols() } );
+		QVERIFY2( errOrValue, qPrintable( formula ) );
+		const auto result = errOrValue.value()->get( C(0,0) );
+		QVERIFY2( FUZZY_CMP_C( result, value ), qPrintable( formula ) );
+	}
+}
+
 /*
 void TestFormulaFunction::testResolution_data() {
 	QTest::addColumn<uint>("interpolation");
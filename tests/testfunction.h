@@ -10,6 +10,16 @@ private slots:
 	void testInit();
 	void testEval();
 	void testEvalWithParameters();
+	void testParameterHandles();
+	void testStateSnapshot();
+	void testFilters();
+	void testDelayLine();
+	void testHarmonics();
+	void testPhasor();
+	void testRandom();
+	void testConvolve();
+	void testFFT();
+	void testRealFastPaths();
 	/*
 	void testResolution_data();
 	void testResolution();
@@ -1,10 +1,17 @@
 #include "testmodel.h"
 #include "testutils.h"
+#include "fge/model/model_impl.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <qcoreapplication.h>
 #include <qfloat16.h>
 #include <qtestcase.h>
 #include <stdexcept>
+#include <thread>
 
 QTEST_MAIN(TestModel)
 #include "testmodel.moc"
@@ -22,6 +29,40 @@ void assertCorrectGraph(
 		const std::vector<std::pair<QString, std::function<C(T)>>>& expectedResult
 );
 
+/* enable audio scheduling, render
+ * (fake audio) until the master
+ * envelope has been ramped up:
+ */
+bool startAudio(
+		const std::shared_ptr<Model> model,
+		PlaybackPosition* position,
+		const uint samplerate
+);
+
+/* results of async calls,
+ * written by the model worker:
+ */
+struct AsyncResults {
+	std::mutex lock;
+	std::condition_variable signal;
+	std::vector<MaybeError> errors;
+	std::vector<uint> previousSizes;
+	uint done = 0;
+
+	bool waitFor( const uint count ) {
+		std::unique_lock guard( lock );
+		return signal.wait_for( guard, std::chrono::seconds(10), [&]{ return done >= count; } );
+	}
+	void add( std::function<void()> f ) {
+		{
+			std::unique_lock guard( lock );
+			f();
+			done++;
+		}
+		signal.notify_all();
+	}
+};
+
 /* TEST */
 
 void TestModel::testInit() {
@@ -211,6 +252,361 @@ void TestModel::testValuesToBuffer()
 	QVERIFY( buffer != std::vector<float>(samplerate, 0) );
 }
 
+void TestModel::testGraphState()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x" } );
+	// counts evaluations:
+	auto maybeError = model->bulkUpdate( 0, {
+			.formula = "s := s + 0.000001; s",
+			.stateDescriptions = StateDescriptions{ { "s", StateDescription{ .size = 1 } } }
+	});
+	QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	model->setIsPlaybackEnabled( 0, true );
+
+	// the master envelope starts at 0,
+	// render until it has been ramped up:
+	const uint samplerate = 44100;
+	auto enabled = std::make_shared<std::atomic<bool>>( false );
+	model->setAudioSchedulingEnabledAsync( true, [enabled]{
+			*enabled = true;
+	});
+	PlaybackPosition position = 0;
+	{
+		std::vector<float> buffer( 256, 0 );
+		for( uint i=0; i<10000 && !*enabled; i++ ) {
+			model->valuesToBuffer( &buffer, position, samplerate );
+			position += buffer.size();
+			model->betweenAudio( position, samplerate );
+			std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		}
+	}
+	QVERIFY( *enabled );
+
+	std::vector<float> before( 4, 0 );
+	model->valuesToBuffer( &before, position, samplerate );
+	position += before.size();
+	QVERIFY( before[0] > 0 );
+	// one evaluation per sample
+	// (scaled by the envelope):
+	const double step = before[1] - before[0];
+	QVERIFY( step > 0 );
+	QVERIFY( std::abs( (before[3] - before[2]) - step ) < 1e-8 );
+
+	// graphs start from the initial state
+	// and leave the audio state alone:
+	for( uint i=0; i<2; i++ ) {
+		auto graph = model->getGraph( 0, {0, 1}, 4 );
+		QVERIFY( graph );
+		QCOMPARE( graph.value().size(), 4 );
+		QCOMPARE( graph.value()[0].second.c_.real(), 0.000001 );
+		QCOMPARE( graph.value()[3].second.c_.real(), 0.000004 );
+	}
+	std::vector<float> after( 4, 0 );
+	model->valuesToBuffer( &after, position, samplerate );
+	QVERIFY2(
+			std::abs( (after[0] - before[3]) - step ) < 1e-8,
+			qPrintable( QString("audio state not continued: %1 -> %2").arg( before[3] ).arg( after[0] ) )
+	);
+}
+
+void TestModel::testProfileAttribution()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x", "2*f0(x)" } );
+	const uint resolution = 100;
+	QVERIFY( model->getGraph( 1, {0, 1}, resolution ) );
+	const auto statistics = model->getNodeStatistics();
+	QCOMPARE( statistics.size(), 2 );
+	// f0 is evaluated on behalf of f1:
+	for( const auto& node : statistics ) {
+		QCOMPARE( node.graph.calls, resolution );
+		QCOMPARE( node.graph.samples, resolution );
+		QCOMPARE( node.audio.calls, 0u );
+		QVERIFY( node.graph.selfNs <= node.graph.totalNs );
+	}
+	// f1 includes the time spent in f0:
+	QVERIFY( statistics[1].graph.totalNs >= statistics[0].graph.totalNs );
+	QVERIFY( statistics[1].graph.selfNs <= statistics[1].graph.totalNs - statistics[0].graph.totalNs + 1e-6 );
+	// counters accumulate:
+	QVERIFY( model->getGraph( 0, {0, 1}, resolution ) );
+	QCOMPARE( model->getNodeStatistics()[0].graph.calls, 2 * resolution );
+	QCOMPARE( model->getNodeStatistics()[1].graph.calls, resolution );
+}
+
+void TestModel::testRandomPerSlot()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "rnd()", "rnd()" } );
+	auto graph0 = model->getGraph( 0, {0, 1}, 8 );
+	auto graph1 = model->getGraph( 1, {0, 1}, 8 );
+	QVERIFY( graph0 && graph1 );
+	// graphs start from the seed:
+	QCOMPARE( model->getGraph( 0, {0, 1}, 8 ), graph0 );
+	// identical formulas aren't correlated:
+	QVERIFY( graph0.value() != graph1.value() );
+}
+
+void TestModel::testRandomAcrossRamp()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x" } );
+	auto maybeError = model->bulkUpdate( 0, {
+			.formula = "rnd() + 0*a",
+			.parameters = ParameterBindings{ { "a", C(0,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "a", ParameterDescription{ .rampType = FadeType::RampParameter } }
+			}
+	});
+	QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	model->setIsPlaybackEnabled( 0, true );
+	const uint samplerate = 44100;
+	PlaybackPosition position = 0;
+	QVERIFY( startAudio( model, &position, samplerate ) );
+
+	const auto ramped = model->scheduleSetParameterValues( 0, { { "a", C(1,0) } }, [](auto, auto){} );
+	QCOMPARE( ramped.size(), 1 );
+	// within the ramp, which sets `a` every sample:
+	std::vector<float> buffer( samplerate * parameterRampTime / 2, 0 );
+	model->valuesToBuffer( &buffer, position, samplerate );
+	// the sequence is not restarted:
+	const std::set<float> distinct( buffer.begin(), buffer.end() );
+	QVERIFY2(
+			distinct.size() > buffer.size() / 2,
+			qPrintable( QString("%1 distinct values in %2 samples").arg( distinct.size() ).arg( buffer.size() ) )
+	);
+}
+
+void TestModel::testFilterAcrossRamp()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x" } );
+	// dc input, passes the lowpasses:
+	auto maybeError = model->bulkUpdate( 0, {
+			.formula = "0.5 * (onepole(1, c, a) + real(svf(1, c, 0.7, b)))",
+			.parameters = ParameterBindings{ { "c", C(0.01,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "c", ParameterDescription{ .initial = 0.01, .max = 0.5, .rampType = FadeType::RampParameter } }
+			},
+			.stateDescriptions = StateDescriptions{
+				{ "a", StateDescription{ .size = 3 } },
+				{ "b", StateDescription{ .size = 5 } }
+			}
+	});
+	QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	model->setIsPlaybackEnabled( 0, true );
+	const uint samplerate = 44100;
+	PlaybackPosition position = 0;
+	QVERIFY( startAudio( model, &position, samplerate ) );
+
+	std::vector<float> before( 256, 0 );
+	model->valuesToBuffer( &before, position, samplerate );
+	position += before.size();
+	const float settled = before.back();
+	QVERIFY( settled > 0 );
+
+	const auto ramped = model->scheduleSetParameterValues( 0, { { "c", C(0.2,0) } }, [](auto, auto){} );
+	QCOMPARE( ramped.size(), 1 );
+	// the whole ramp:
+	std::vector<float> buffer( samplerate * parameterRampTime * 1.5, 0 );
+	model->valuesToBuffer( &buffer, position, samplerate );
+	// the filters keep their memory,
+	// dc stays where it was:
+	float last = settled;
+	for( uint i=0; i<buffer.size(); i++ ) {
+		QVERIFY2(
+				std::abs( buffer[i] - last ) < 1e-3 * settled,
+				qPrintable( QString("discontinuity at sample %1: %2 -> %3").arg( i ).arg( last ).arg( buffer[i] ) )
+		);
+		last = buffer[i];
+	}
+}
+
+void TestModel::testAsyncUpdates()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x-1", "f0(x)" } );
+	// fake audio:
+	std::jthread audioThread([&model](std::stop_token stop) {
+		const uint samplerate = 44100;
+		std::vector<float> buffer( 256, 0 );
+		PlaybackPosition position = 0;
+		while( !stop.stop_requested() ) {
+			model->valuesToBuffer( &buffer, position, samplerate );
+			position += buffer.size();
+			model->betweenAudio( position, samplerate );
+			std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		}
+	});
+	auto results = std::make_shared<AsyncResults>();
+	model->setAudioSchedulingEnabledAsync( true, [results]{
+			results->add( []{} );
+	});
+	QVERIFY( results->waitFor( 1 ) );
+
+	// issued without waiting,
+	// the 2nd update relies on
+	// the state declared by the 1st:
+	auto collectError = [results](auto maybeError) {
+		results->add( [&]{ results->errors.push_back( maybeError ); } );
+	};
+	model->bulkUpdateAsync( 0, {
+			.formula = "s := s + 1; x",
+			.stateDescriptions = StateDescriptions{ { "s", StateDescription{ .size = 1 } } }
+	}, collectError );
+	model->bulkUpdateAsync( 0, { .formula = "s := x + 1; s" }, collectError );
+	model->bulkUpdateAsync( 1, { .formula = "2*f0(x)" }, collectError );
+	QVERIFY( results->waitFor( 4 ) );
+	for( const auto& maybeError : results->errors ) {
+		QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	}
+	QCOMPARE( model->get(0).formula, QString("s := x + 1; s") );
+	QCOMPARE( model->get(1).formula, QString("2*f0(x)") );
+	QVERIFY( model->get(0).stateDescriptions.contains( "s" ) );
+
+	// previous size as scheduled:
+	auto collectSize = [results](auto previousSize) {
+		results->add( [&]{ results->previousSizes.push_back( previousSize ); } );
+	};
+	model->resizeAsync( 3, collectSize );
+	model->resizeAsync( 1, collectSize );
+	QVERIFY( results->waitFor( 6 ) );
+	QCOMPARE( results->previousSizes, std::vector<uint>({ 2, 3 }) );
+	QCOMPARE( model->size(), 1 );
+
+	model->setAudioSchedulingEnabledAsync( false, [results]{
+			results->add( []{} );
+	});
+	QVERIFY( results->waitFor( 7 ) );
+	QVERIFY( !model->getAudioSchedulingEnabled() );
+}
+
+void TestModel::testCoalesceSetters()
+{
+	using Task = std::variant<
+		ResizeTask,
+		SetTask,
+		SetParameterValuesTask,
+		SetIsPlaybackEnabledTask
+	>;
+	std::deque<Task> tasks;
+	uint callbacks = 0;
+	auto done = [&callbacks]{ callbacks++; };
+	// superseded by the later values on 0:
+	makeSetter<::setParameterValues>( tasks, 0, done, 0u, ParameterBindings{ { "a", C(1,0) }, { "b", C(1,0) } } );
+	// superseded by the set on 1:
+	makeSetter<::setParameterValues>( tasks, 0, done, 1u, ParameterBindings{ { "a", C(5,0) } } );
+	makeSetter<::setParameterValues>( tasks, 0, done, 0u, ParameterBindings{ { "b", C(2,0) }, { "c", C(3,0) } } );
+	// superseded by the later set on 1:
+	makeSetter<::set>( tasks, 0, done, 1u, QString("x"), ParameterBindings{}, StateDescriptions{} );
+	makeSetter<::set>( tasks, 0, done, 1u, QString("2*x"), ParameterBindings{}, StateDescriptions{} );
+	makeSetter<::resize>( tasks, 0, done, 3u );
+	// not superseded across the resize:
+	makeSetter<::set>( tasks, 0, done, 0u, QString("x"), ParameterBindings{}, StateDescriptions{} );
+	makeSetter<::setIsPlaybackEnabled>( tasks, 0, done, 0u, true );
+	makeSetter<::setIsPlaybackEnabled>( tasks, 0, done, 0u, false );
+	// different index:
+	makeSetter<::setIsPlaybackEnabled>( tasks, 0, done, 1u, true );
+
+	const auto superseded = coalesceSetters( tasks.begin(), tasks.end() );
+	QCOMPARE( superseded, std::vector<bool>({
+			true, true, false, true, false,
+			false,
+			false, true, false, false
+	}) );
+	// later values win, earlier ones are merged:
+	const auto merged = std::get<1>( std::get<SetParameterValuesTask>( tasks[2] ).args );
+	QCOMPARE( merged, ParameterBindings({ { "a", C(1,0) }, { "b", C(2,0) }, { "c", C(3,0) } }) );
+	// the later set is left as it is:
+	QCOMPARE( std::get<1>( std::get<SetTask>( tasks[4] ).args ), QString("2*x") );
+	// only up to `end`:
+	QCOMPARE( coalesceSetters( tasks.begin(), tasks.begin() + 4 ), std::vector<bool>({ true, true, false, false }) );
+	// values before and after a set of the same entry
+	// belong to different formulas, don't merge them:
+	std::deque<Task> acrossSet;
+	makeSetter<::setParameterValues>( acrossSet, 0, done, 0u, ParameterBindings{ { "a", C(1,0) } } );
+	makeSetter<::set>( acrossSet, 0, done, 0u, QString("x"), ParameterBindings{ { "b", C(2,0) } }, StateDescriptions{} );
+	makeSetter<::setParameterValues>( acrossSet, 0, done, 0u, ParameterBindings{ { "b", C(3,0) } } );
+	QCOMPARE( coalesceSetters( acrossSet.begin(), acrossSet.end() ), std::vector<bool>({ true, false, false }) );
+	QCOMPARE( std::get<1>( std::get<SetParameterValuesTask>( acrossSet[2] ).args ), ParameterBindings({ { "b", C(3,0) } }) );
+	QCOMPARE( callbacks, 0 );
+}
+
+void TestModel::testBatchedUpdates()
+{
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x" } );
+	model->setIsPlaybackEnabled( 0, true );
+	// fake audio, driven by the test:
+	const uint samplerate = 44100;
+	PlaybackPosition position = 0;
+	std::vector<float> buffer( 256, 0 );
+	auto results = std::make_shared<AsyncResults>();
+	auto pumpUntil = [&](const uint count) {
+		for( uint i=0; i<10000; i++ ) {
+			{
+				std::unique_lock guard( results->lock );
+				if( results->done >= count ) {
+					return true;
+				}
+			}
+			model->valuesToBuffer( &buffer, position, samplerate );
+			position += buffer.size();
+			model->betweenAudio( position, samplerate );
+			std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		}
+		return false;
+	};
+	model->setAudioSchedulingEnabledAsync( true, [results]{
+			results->add( []{} );
+	});
+	QVERIFY( pumpUntil( 1 ) );
+
+	// a burst of edits, no audio in between:
+	auto collectError = [results](auto maybeError) {
+		results->add( [&]{ results->errors.push_back( maybeError ); } );
+	};
+	model->bulkUpdateAsync( 0, { .formula = "x +" }, collectError );
+	model->bulkUpdateAsync( 0, { .formula = "x + 1" }, collectError );
+	model->bulkUpdateAsync( 0, { .formula = "2*x" }, collectError );
+	QVERIFY( pumpUntil( 4 ) );
+	// one fade, the setters are run as one batch.
+	// the superseded (invalid) formulas
+	// are never compiled:
+	QCOMPARE( results->errors.size(), 3 );
+	for( const auto& maybeError : results->errors ) {
+		QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	}
+	QCOMPARE( model->get(0).formula, QString("2*x") );
+	QVERIFY( !model->getError(0) );
+
+	model->setAudioSchedulingEnabledAsync( false, [results]{
+			results->add( []{} );
+	});
+	QVERIFY( pumpUntil( 5 ) );
+}
+
+void TestModel::testSkippedSetters()
+{
+	std::deque<std::variant<SetTask, SetIsPlaybackEnabledTask>> tasks;
+	uint callbacks = 0;
+	auto done = [&callbacks]{ callbacks++; };
+	auto setFuture = makeSetter<::set>( tasks, 0, done, 0u, QString("x"), ParameterBindings{}, StateDescriptions{} );
+	auto enableFuture = makeSetter<::setIsPlaybackEnabled>( tasks, 0, done, 0u, true );
+	auto skipSet = skip( &std::get<SetTask>( tasks[0] ) );
+	auto skipEnable = skip( &std::get<SetIsPlaybackEnabledTask>( tasks[1] ) );
+	// the callbacks don't refer to the tasks:
+	tasks.clear();
+	QVERIFY( setFuture.wait_for( std::chrono::seconds(0) ) == std::future_status::timeout );
+	skipSet();
+	skipEnable();
+	QCOMPARE( callbacks, 2 );
+	// resolved without an error:
+	QVERIFY( setFuture.wait_for( std::chrono::seconds(0) ) == std::future_status::ready );
+	QVERIFY( !setFuture.get() );
+	QVERIFY( enableFuture.wait_for( std::chrono::seconds(0) ) == std::future_status::ready );
+	enableFuture.get();
+}
 
 /* utilities */
 
@@ -294,3 +690,23 @@ void assertCorrectGraph(
 		}
 	}
 }
+
+bool startAudio(
+		const std::shared_ptr<Model> model,
+		PlaybackPosition* position,
+		const uint samplerate
+)
+{
+	auto enabled = std::make_shared<std::atomic<bool>>( false );
+	model->setAudioSchedulingEnabledAsync( true, [enabled]{
+			*enabled = true;
+	});
+	std::vector<float> buffer( 256, 0 );
+	for( uint i=0; i<10000 && !*enabled; i++ ) {
+		model->valuesToBuffer( &buffer, *position, samplerate );
+		*position += buffer.size();
+		model->betweenAudio( *position, samplerate );
+		std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+	}
+	return *enabled;
+}
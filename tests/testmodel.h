@@ -18,6 +18,15 @@ private slots:
 	void testUpdatesReferences();
 	void testGetGraph();
 	void testValuesToBuffer();
+	void testGraphState();
+	void testProfileAttribution();
+	void testRandomPerSlot();
+	void testRandomAcrossRamp();
+	void testFilterAcrossRamp();
+	void testAsyncUpdates();
+	void testCoalesceSetters();
+	void testBatchedUpdates();
+	void testSkippedSetters();
 };
 
 #endif
@@ -0,0 +1,157 @@
+#include "testrealtime.h"
+#include "fge/render/offline_renderer.h"
+#include "fge/shared/rt_safety.h"
+#include <mutex>
+
+QTEST_MAIN(TestRealtime)
+#include "testrealtime.moc"
+
+
+/* These tests need a build with
+ * `-DFGE_RT_SAFETY=ON`, otherwise
+ * nothing is intercepted.
+ */
+
+#define SKIP_IF_DISABLED() \
+	if constexpr( !rt_safety::enabled() ) { \
+		QSKIP( "rt_safety disabled, rebuild with -DFGE_RT_SAFETY=ON" ); \
+	}
+
+// UTILS:
+
+// the (representative) patch:
+// parameter ramps, state, dependencies, loops
+MaybeError initPatch( Model* model )
+{
+	const std::vector<Model::Update> updates = {
+		{
+			.formula = "sin(2*pi*freq*x)",
+			.parameters = ParameterBindings{ { "freq", C(220,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "freq", ParameterDescription{ .initial = 220, .min = 20, .max = 2000, .rampType = FadeType::RampParameter } }
+			},
+		},
+		{
+			.formula = (QStringList {
+				"var acc := 0;",
+				"for( var k:=1; k<=8; k+=1 ) {",
+				"  acc += cos( k*110*2pi*x ) / k;",
+				"};",
+				"0.5*f0(x) + 0.1*acc;"
+			}).join("\n"),
+		},
+		{
+			.formula = "s := 0.99*s + 0.01*f1(x); vol * (f1(x) - s)",
+			.parameters = ParameterBindings{ { "vol", C(0.5,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "vol", ParameterDescription{ .initial = 0.5 } }
+			},
+			.stateDescriptions = StateDescriptions{ { "s", StateDescription{ .size = 1 } } },
+			.playbackEnabled = true
+		},
+	};
+	model->resize( updates.size() );
+	for( uint i=0; i<updates.size(); i++ ) {
+		if( auto maybeError = model->bulkUpdate( i, updates[i] ) ) {
+			return maybeError;
+		}
+	}
+	return {};
+}
+
+/* TEST */
+
+void TestRealtime::init() {
+	rt_safety::reset();
+}
+
+void TestRealtime::testDetectAllocation() {
+	SKIP_IF_DISABLED();
+	std::vector<std::vector<float>> allocated;
+	allocated.reserve( 1 );
+	{
+		rt_safety::Realtime realtime;
+		FGE_RT_SCOPE( "test scope" );
+		allocated.emplace_back( 64 );
+	}
+	const auto violations = rt_safety::violations();
+	QVERIFY( violations.size() > 0 );
+	QVERIFY( violations[0].kind == rt_safety::ViolationKind::Allocation );
+	QVERIFY( violations[0].tagCount > 0 );
+	QCOMPARE( QString( violations[0].tags[violations[0].tagCount-1] ), QString( "test scope" ) );
+	// other threads are not checked:
+	rt_safety::reset();
+	allocated.emplace_back( 64 );
+	QCOMPARE( rt_safety::violationCount(), uint64_t(0) );
+}
+
+void TestRealtime::testDetectLock() {
+	SKIP_IF_DISABLED();
+	std::mutex mutex;
+	{
+		rt_safety::Realtime realtime;
+		std::scoped_lock lock( mutex );
+	}
+	const auto violations = rt_safety::violations();
+	QCOMPARE( violations.size(), size_t(1) );
+	QVERIFY( violations[0].kind == rt_safety::ViolationKind::Lock );
+	QCOMPARE( rt_safety::violationCount( rt_safety::ViolationKind::Lock ), uint64_t(1) );
+	QCOMPARE( rt_safety::violationCount( rt_safety::ViolationKind::Allocation ), uint64_t(0) );
+	// try_lock doesn't block:
+	rt_safety::reset();
+	{
+		rt_safety::Realtime realtime;
+		QVERIFY( mutex.try_lock() );
+		mutex.unlock();
+	}
+	QCOMPARE( rt_safety::violationCount(), uint64_t(0) );
+}
+
+void TestRealtime::testAllow() {
+	SKIP_IF_DISABLED();
+	std::vector<std::vector<float>> allocated;
+	allocated.reserve( 1 );
+	{
+		rt_safety::Realtime realtime;
+		rt_safety::Allow allow;
+		allocated.emplace_back( 64 );
+	}
+	QCOMPARE( rt_safety::violationCount(), uint64_t(0) );
+}
+
+void TestRealtime::testRenderPatch() {
+	SKIP_IF_DISABLED();
+	auto model = modelFactory();
+	const auto maybeError = initPatch( model.get() );
+	QVERIFY2( !maybeError, maybeError.value_or("").toStdString().c_str() );
+	const RenderSettings settings{
+		.samplerate = 44100,
+		.duration = 3,
+		.blockSize = 256
+	};
+	OfflineRenderer renderer( model.get(), settings );
+	rt_safety::reset();
+	// the sink plays the gui, changing
+	// parameters while rendering:
+	uint block = 0;
+	auto maybeStatistics = renderer.render( [&model,&block](const std::vector<float>&) -> MaybeError {
+			block++;
+			if( block % 32 == 0 ) {
+				model->scheduleSetParameterValues(
+						0,
+						{ { "freq", C( (block / 32) % 2 ? 330.0 : 220.0, 0 ) } },
+						[](auto, auto){}
+				);
+			}
+			return {};
+	});
+	QVERIFY2( maybeStatistics, maybeStatistics ? "" : maybeStatistics.error().toStdString().c_str() );
+	// the model blocks on its own locks
+	// (reported, but known), it must not
+	// allocate though:
+	QVERIFY2(
+			rt_safety::violationCount( rt_safety::ViolationKind::Allocation ) == 0
+			&& rt_safety::violationCount( rt_safety::ViolationKind::Deallocation ) == 0,
+			rt_safety::report().toStdString().c_str()
+	);
+}
@@ -0,0 +1,18 @@
+#ifndef TESTREALTIME_H
+#define TESTREALTIME_H
+
+#include <QTest>
+
+
+class TestRealtime: public QObject
+{
+	Q_OBJECT
+private slots:
+	void init();
+	void testDetectAllocation();
+	void testDetectLock();
+	void testAllow();
+	void testRenderPatch();
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "testrender.h"
+#include "testutils.h"
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstring>
+
+QTEST_MAIN(TestRender)
+#include "testrender.moc"
+
+
+// UTILS:
+
+uint32_t readUInt32LE( const QByteArray& data, const uint offset )
+{
+	uint32_t ret = 0;
+	for( uint i=0; i<4; i++ ) {
+		ret |= uint32_t( uint8_t(data[offset+i]) ) << (8*i);
+	}
+	return ret;
+}
+
+uint16_t readUInt16LE( const QByteArray& data, const uint offset )
+{
+	return uint16_t(uint8_t(data[offset])) | (uint16_t(uint8_t(data[offset+1])) << 8);
+}
+
+/* TEST */
+
+void TestRender::testWavHeader() {
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+	const auto path = dir.filePath( "test.wav" );
+	auto writer = audioFileWriterFactory( AudioFileFormat::Wav ).value();
+	QVERIFY( !writer->open( path, { .sampleFormat = SampleFormat::Int16, .samplerate = 48000 } ) );
+	QVERIFY( !writer->write( std::vector<float>( 100, 0.5 ) ) );
+	QVERIFY( !writer->close() );
+
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::ReadOnly ) );
+	const auto data = file.readAll();
+	QCOMPARE( data.size(), 44 + 100 * 2 );
+	QCOMPARE( data.mid(0,4), QByteArray("RIFF") );
+	QCOMPARE( readUInt32LE( data, 4 ), uint32_t(data.size() - 8) );
+	QCOMPARE( data.mid(8,4), QByteArray("WAVE") );
+	QCOMPARE( readUInt16LE( data, 20 ), 1 ); // PCM
+	QCOMPARE( readUInt16LE( data, 22 ), 1 ); // channels
+	QCOMPARE( readUInt32LE( data, 24 ), 48000u );
+	QCOMPARE( readUInt16LE( data, 34 ), 16 );
+	QCOMPARE( data.mid(36,4), QByteArray("data") );
+	QCOMPARE( readUInt32LE( data, 40 ), 200u );
+	QCOMPARE( int16_t(readUInt16LE( data, 44 )), int16_t(16384) );
+}
+
+void TestRender::testRenderSampleCount() {
+	QTemporaryDir dir;
+	QVERIFY( dir.isValid() );
+	const auto path = dir.filePath( "test.wav" );
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "sin(x)" } );
+	model->setIsPlaybackEnabled( 0, true );
+	const RenderSettings settings{
+		.samplerate = 8000,
+		.duration = 0.5,
+		.blockSize = 300
+	};
+	OfflineRenderer renderer( model.get(), settings );
+	auto maybeStatistics = renderer.render(
+			path,
+			{ .sampleFormat = SampleFormat::Float32 }
+	);
+	QVERIFY2( maybeStatistics, maybeStatistics ? "" : maybeStatistics.error().toStdString().c_str() );
+	QCOMPARE( maybeStatistics->samplesRendered, 4000u );
+	QVERIFY( maybeStatistics->realtimeFactor( settings.samplerate ) > 0 );
+
+	QFile file( path );
+	QVERIFY( file.open( QIODevice::ReadOnly ) );
+	const auto data = file.readAll();
+	QCOMPARE( readUInt16LE( data, 20 ), 3 ); // IEEE float
+	QCOMPARE( readUInt32LE( data, 24 ), 8000u );
+	QCOMPARE( readUInt32LE( data, 40 ), 4000u * 4 );
+	QCOMPARE( data.size(), 44 + 4000 * 4 );
+	// model state is restored:
+	QVERIFY( !model->getAudioSchedulingEnabled() );
+}
+
+void TestRender::testRenderBlocks() {
+	// a ramp, so that dropped or
+	// repeated samples show:
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x - 0.5" } );
+	model->setIsPlaybackEnabled( 0, true );
+	const RenderSettings settings{
+		.samplerate = 1000,
+		.duration = 1,
+		.blockSize = 128
+	};
+	OfflineRenderer renderer( model.get(), settings );
+	std::vector<float> rendered;
+	std::vector<size_t> blockSizes;
+	auto maybeStatistics = renderer.render( [&rendered,&blockSizes](const auto& block) -> MaybeError {
+			blockSizes.push_back( block.size() );
+			rendered.insert( rendered.end(), block.begin(), block.end() );
+			return {};
+	});
+	QVERIFY( maybeStatistics );
+	QCOMPARE( maybeStatistics->samplesRendered, 1000u );
+	QCOMPARE( rendered.size(), 1000u );
+	// full blocks, the last one truncated:
+	const std::vector<size_t> expectedBlockSizes = { 128, 128, 128, 128, 128, 128, 128, 104 };
+	QVERIFY( blockSizes == expectedBlockSizes );
+	// rendering starts at 0,
+	// one function => unscaled:
+	for( uint i=0; i<rendered.size(); i++ ) {
+		const double expected = double(i) / settings.samplerate - 0.5;
+		QVERIFY2(
+				std::abs( rendered[i] - expected ) < 1e-6,
+				qPrintable( QString( "sample %1: %2 != %3 (expected)" ).arg( i ).arg( rendered[i] ).arg( expected ) )
+		);
+	}
+	// continuous across block boundaries:
+	for( uint i=settings.blockSize; i<rendered.size(); i+=settings.blockSize ) {
+		QVERIFY( std::abs( (rendered[i] - rendered[i-1]) - 1.0 / settings.samplerate ) < 1e-6 );
+	}
+}
+
+void TestRender::testRenderState() {
+	// counts evaluations:
+	auto model = modelFactory();
+	initTestModel( model.get(), std::vector<QString>{ "x" } );
+	auto maybeError = model->bulkUpdate( 0, {
+			.formula = "s := s + 1; s / 1000",
+			.stateDescriptions = StateDescriptions{ { "s", StateDescription{ .size = 1 } } },
+			.playbackEnabled = true
+	});
+	QVERIFY2( !maybeError, qPrintable( maybeError.value_or( "" ) ) );
+	const RenderSettings settings{
+		.samplerate = 1000,
+		.duration = 0.3,
+		.blockSize = 64
+	};
+	OfflineRenderer renderer( model.get(), settings );
+	for( uint run=0; run<2; run++ ) {
+		std::vector<float> rendered;
+		auto maybeStatistics = renderer.render( [&rendered](const auto& block) -> MaybeError {
+				rendered.insert( rendered.end(), block.begin(), block.end() );
+				return {};
+		});
+		QVERIFY( maybeStatistics );
+		QVERIFY( maybeStatistics->blockStatistics.avg_time <= maybeStatistics->blockStatistics.max_time );
+		// the pre-roll doesn't count:
+		QCOMPARE( rendered.size(), 300u );
+		for( uint i=0; i<rendered.size(); i++ ) {
+			const double expected = double(i+1) / 1000;
+			QVERIFY2(
+					std::abs( rendered[i] - expected ) < 1e-6,
+					qPrintable( QString( "run %1, sample %2: %3 != %4 (expected)" ).arg( run ).arg( i ).arg( rendered[i] ).arg( expected ) )
+			);
+		}
+	}
+}
+
+void TestRender::testFlacUnsupported() {
+	QCOMPARE(
+			audioFileFormatFromPath( "out.FLAC" ),
+			AudioFileFormat::Flac
+	);
+	QCOMPARE(
+			audioFileFormatFromPath( "out.wav" ),
+			AudioFileFormat::Wav
+	);
+	auto maybeWriter = audioFileWriterFactory( AudioFileFormat::Flac );
+	QCOMPARE(
+			maybeWriter.has_value(),
+			isAudioFileFormatSupported( AudioFileFormat::Flac )
+	);
+}
@@ -0,0 +1,20 @@
+#ifndef TESTRENDER_H
+#define TESTRENDER_H
+
+#include "fge/render/offline_renderer.h"
+
+#include <QTest>
+
+
+class TestRender: public QObject
+{
+	Q_OBJECT
+private slots:
+	void testWavHeader();
+	void testRenderSampleCount();
+	void testRenderBlocks();
+	void testRenderState();
+	void testFlacUnsupported();
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include <qtestcase.h>
+#include "testshared.h"
+#include "fge/shared/concurrency_utils.h"
+#include "fge/shared/latency_histogram.h"
+#include "fge/shared/lock_statistics.h"
+#include "fge/shared/profiler.h"
+#include <future>
+#include <thread>
+
+QTEST_MAIN(TestShared)
+#include "testshared.moc"
+
+
+// UTILS:
+
+using namespace std::chrono_literals;
+
+// burn at least `ticks` profiler ticks:
+void spin( const profiler::ticks_t ticks )
+{
+	const auto start = profiler::now();
+	while( profiler::now() - start < ticks ) {}
+}
+
+/* TEST */
+
+void TestShared::testProfilerScopes() {
+	using profiler::Context;
+	constexpr profiler::ticks_t outerTicks = 20000;
+	constexpr profiler::ticks_t innerTicks = 50000;
+	ProfileSlot outer, inner;
+	profiler::ContextGuard context( Context::Audio );
+	{
+		ProfileScope outerScope( &outer );
+		spin( outerTicks );
+		for( uint i=0; i<2; i++ ) {
+			ProfileScope innerScope( &inner );
+			spin( innerTicks );
+		}
+	}
+	const auto& o = outer.running[size_t(Context::Audio)];
+	const auto& in = inner.running[size_t(Context::Audio)];
+	QCOMPARE( o.calls, 1u );
+	QCOMPARE( in.calls, 2u );
+	QVERIFY( in.total >= 2 * innerTicks );
+	// nothing nested in inner:
+	QCOMPARE( in.self, in.total );
+	// time in nested scopes is only "total":
+	QVERIFY( o.total >= outerTicks + in.total );
+	QCOMPARE( o.self, o.total - in.total );
+	QVERIFY( o.self >= outerTicks );
+	// the other context is untouched:
+	QCOMPARE( outer.running[size_t(Context::Graph)].calls, 0u );
+
+	// publishing moves the running counters:
+	const auto total = in.total;
+	inner.publish( Context::Audio, 128 );
+	QCOMPARE( in.calls, 0u );
+	QCOMPARE( in.total, 0u );
+	QCOMPARE( inner.published[size_t(Context::Audio)].total.load(), total );
+	const auto counts = inner.read( Context::Audio );
+	QCOMPARE( counts.calls, 2u );
+	QCOMPARE( counts.samples, 128u );
+	QVERIFY( counts.totalNs > 0 );
+	QCOMPARE( counts.selfNs, counts.totalNs );
+	// published counters are monotonic:
+	{
+		ProfileScope innerScope( &inner );
+	}
+	inner.publish( Context::Audio, 64 );
+	QCOMPARE( inner.read( Context::Audio ).calls, 3u );
+	QCOMPARE( inner.read( Context::Audio ).samples, 192u );
+}
+
+void TestShared::testProfilerContexts() {
+	using profiler::Context;
+	ProfileSlot slot;
+	QCOMPARE( profiler::currentContext(), Context::None );
+	{
+		// outside of a context nothing is counted:
+		ProfileScope scope( &slot );
+		spin( 1000 );
+	}
+	for( const auto& counters : slot.running ) {
+		QCOMPARE( counters.calls, 0u );
+		QCOMPARE( counters.total, 0u );
+	}
+	{
+		profiler::ContextGuard graph( Context::Graph );
+		{
+			ProfileScope scope( &slot );
+		}
+		{
+			profiler::ContextGuard audio( Context::Audio );
+			QCOMPARE( profiler::currentContext(), Context::Audio );
+			ProfileScope scope( &slot );
+			ProfileScope noSlot( nullptr );
+		}
+		QCOMPARE( profiler::currentContext(), Context::Graph );
+	}
+	QCOMPARE( profiler::currentContext(), Context::None );
+	QCOMPARE( slot.running[size_t(Context::Graph)].calls, 1u );
+	QCOMPARE( slot.running[size_t(Context::Audio)].calls, 1u );
+}
+
+void TestShared::testLatencyHistogram() {
+	using std::chrono::nanoseconds;
+	// buckets of 1000ns:
+	constexpr auto deadline = nanoseconds( 1000 * LatencyHistogram::resolution );
+	const auto upperBound = [](const uint bucket) {
+		return double(bucket + 1) / LatencyHistogram::resolution;
+	};
+	LatencyHistogram histogram;
+	QCOMPARE( histogram.percentiles().count, uint64_t(0) );
+	QCOMPARE( histogram.percentiles().p50, 0.0 );
+	// bucket placement:
+	histogram.record( nanoseconds( 1500 ), deadline );
+	QCOMPARE( histogram.percentiles().p50, upperBound( 1 ) );
+	histogram.clear();
+	histogram.record( nanoseconds( -5 ), deadline );
+	QCOMPARE( histogram.percentiles().p50, upperBound( 0 ) );
+	// ignored:
+	histogram.record( nanoseconds( 1500 ), nanoseconds( 0 ) );
+	QCOMPARE( histogram.percentiles().count, uint64_t(1) );
+	histogram.clear();
+	// percentiles:
+	for( uint i=0; i<90; i++ ) {
+		histogram.record( nanoseconds( 10500 ), deadline );
+	}
+	for( uint i=0; i<9; i++ ) {
+		histogram.record( nanoseconds( 20500 ), deadline );
+	}
+	histogram.record( deadline, deadline );
+	{
+		const auto percentiles = histogram.percentiles();
+		QCOMPARE( percentiles.count, uint64_t(100) );
+		QCOMPARE( percentiles.p50, upperBound( 10 ) );
+		QCOMPARE( percentiles.p90, upperBound( 10 ) );
+		QCOMPARE( percentiles.p99, upperBound( 20 ) );
+		QCOMPARE( percentiles.p999, upperBound( 20 ) );
+	}
+	// meeting the deadline exactly is no overrun:
+	QCOMPARE( histogram.getOverruns(), uint64_t(0) );
+	// overflow into the last bucket:
+	for( uint i=0; i<1000; i++ ) {
+		histogram.record( std::chrono::seconds( 1 ), deadline );
+	}
+	{
+		const auto percentiles = histogram.percentiles();
+		QCOMPARE( percentiles.count, uint64_t(1100) );
+		QCOMPARE( percentiles.p50, upperBound( LatencyHistogram::bucketCount - 1 ) );
+		QCOMPARE( percentiles.p50, double(LatencyHistogram::maxRatio) + 1.0 / LatencyHistogram::resolution );
+	}
+	QCOMPARE( histogram.getOverruns(), uint64_t(1000) );
+	histogram.clear();
+	QCOMPARE( histogram.percentiles().count, uint64_t(0) );
+	QCOMPARE( histogram.getOverruns(), uint64_t(0) );
+}
+
+void TestShared::testLockStatistics() {
+#ifndef FGE_MUTEX_STATS
+	QSKIP( "lock statistics disabled, rebuild with -DFGE_MUTEX_STATS=ON" );
+#else
+	// the line of `operation` in the csv report:
+	const auto csvLine = [](const QString& operation) {
+		for( const auto& line : lock_statistics::reportCSV().split( "\n" ) ) {
+			if( line.startsWith( QString("teststatistics,other,%1,").arg( operation ) ) ) {
+				return line.split( "," );
+			}
+		}
+		return QStringList{};
+	};
+	mutex_guarded<int> guarded( 0, "teststatistics" );
+	// uncontended:
+	for( uint i=0; i<3; i++ ) {
+		guarded.write([](auto& value) { value++; });
+	}
+	// contended, held by another thread:
+	std::promise<void> locked, release;
+	auto isLocked = locked.get_future();
+	std::thread holder([&guarded, &locked, future = release.get_future()]{
+			guarded.write([&locked, &future](auto& value) {
+					locked.set_value();
+					future.wait();
+			});
+	});
+	isLocked.wait();
+	QVERIFY( !guarded.try_write([](auto& value) { return value; }) );
+	std::thread waiter([&guarded]{
+			guarded.write([](auto& value) { value++; });
+	});
+	// let the waiter block:
+	std::this_thread::sleep_for( 50ms );
+	release.set_value();
+	holder.join();
+	waiter.join();
+	// guard,thread,operation,acquisitions,contended,failed,...:
+	const auto write = csvLine( "write" );
+	QCOMPARE( write.size(), qsizetype(10) );
+	QCOMPARE( write[3], QString("5") );
+	QCOMPARE( write[4], QString("1") );
+	QCOMPARE( write[5], QString("0") );
+	QVERIFY( write[7].toLongLong() > 0 ); // max wait (ns)
+	const auto tryWrite = csvLine( "try_write" );
+	QCOMPARE( tryWrite.size(), qsizetype(10) );
+	QCOMPARE( tryWrite[3], QString("0") );
+	QCOMPARE( tryWrite[5], QString("1") );
+	QVERIFY( csvLine( "read" ).isEmpty() );
+	lock_statistics::reset();
+	QVERIFY( csvLine( "write" ).isEmpty() );
+	QVERIFY( csvLine( "try_write" ).isEmpty() );
+#endif
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QTest>
+
+class TestShared: public QObject
+{
+	Q_OBJECT
+private slots:
+	void testProfilerScopes();
+	void testProfilerContexts();
+	void testLatencyHistogram();
+	void testLockStatistics();
+};
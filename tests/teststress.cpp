@@ -0,0 +1,383 @@
+#include "teststress.h"
+#include "fge/model/model.h"
+#include "fge/shared/latency_histogram.h"
+#include <QStringList>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+
+QTEST_MAIN(TestStress)
+#include "teststress.moc"
+
+
+/* Headless stress test:
+ * an audio thread renders blocks
+ * on a simulated clock (paced like a
+ * sound server), while the test thread
+ * plays the GUI and randomly edits
+ * the model.
+ *
+ * Environment:
+ *   FGE_STRESS_SECONDS: duration per scenario (default: 2)
+ *   FGE_STRESS_SEED: random seed (default: 1)
+ *   FGE_STRESS_MAX_DEADLINE_MISSES: fail above (default: only report)
+ */
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+// UTILS:
+
+enum class Edit {
+	Formula,
+	Parameter,
+	Resize,
+	Sampling
+};
+constexpr size_t editKindCount = 4;
+
+const char* editName( const Edit edit )
+{
+	switch( edit ) {
+		case Edit::Formula: return "formula";
+		case Edit::Parameter: return "parameter";
+		case Edit::Resize: return "resize";
+		case Edit::Sampling: return "sampling";
+	}
+	return "";
+}
+
+using EditWeights = std::array<double, editKindCount>;
+Q_DECLARE_METATYPE(EditWeights)
+
+struct StressSettings {
+	double duration = 2; // seconds
+	uint samplerate = 44100;
+	uint blockSize = 256;
+	uint seed = 1;
+	EditWeights weights = { 1, 1, 1, 1 };
+	// pause between edits (random):
+	std::chrono::milliseconds maxPause = 20ms;
+	uint minSize = 3;
+	uint maxSize = 6;
+	// sample steps above count as glitch:
+	float maxStep = 0.5;
+};
+
+struct StressResults {
+	// render time per block:
+	LatencyHistogram blockTimes;
+	uint64_t blocks = 0;
+	uint64_t deadlineMisses = 0;
+	uint64_t silentBlocks = 0;
+	uint64_t nonFinite = 0;
+	uint64_t discontinuities = 0;
+	// edit to audible (ms):
+	std::array<std::vector<double>, editKindCount> editLatencies;
+	uint64_t unfinishedParameterEdits = 0;
+	QStringList errors;
+};
+
+// ramps report back from the audio thread:
+struct ParameterEdits {
+	std::mutex lock;
+	std::vector<double> latencies;
+	uint pending = 0;
+	uint done = 0;
+};
+
+double toMs( const Clock::duration duration )
+{
+	return std::chrono::duration<double, std::milli>( duration ).count();
+}
+
+double percentile( std::vector<double> values, const double p )
+{
+	if( values.empty() ) {
+		return 0;
+	}
+	std::sort( values.begin(), values.end() );
+	return values[ size_t( p * double(values.size() - 1) ) ];
+}
+
+double envOr( const char* name, const double defaultValue )
+{
+	const auto value = std::getenv( name );
+	return value ? std::atof( value ) : defaultValue;
+}
+
+/* formulas of entry `index`
+ * only depend on entries before:
+ */
+Model::Update randomUpdate(
+		const uint index,
+		std::mt19937& random
+)
+{
+	auto pick = [&random](const uint size) {
+		return std::uniform_int_distribution<uint>( 0, size-1 )( random );
+	};
+	if( index == 0 ) {
+		const QStringList formulas = {
+			"sin(2*pi*freq*x)",
+			"cos(2*pi*freq*x)",
+			"0.5*sin(2*pi*freq*x) + 0.5*sin(4*pi*freq*x)"
+		};
+		return {
+			.formula = formulas[ pick( formulas.size() ) ],
+			.parameters = ParameterBindings{ { "freq", C(220,0) } },
+			.parameterDescriptions = ParameterDescriptions{
+				{ "freq", ParameterDescription{ .initial = 220, .min = 20, .max = 2000, .rampType = FadeType::RampParameter } }
+			},
+			.playbackEnabled = false
+		};
+	}
+	const auto dependency = QString("f%1(x)").arg( pick( index ) );
+	const auto frequency = 110 * (1 + pick( 4 ));
+	switch( pick( 4 ) ) {
+		case 0:
+			return {
+				.formula = QString("0.5*%1 + 0.25*sin(2*pi*%2*x)").arg( dependency ).arg( frequency ),
+				.playbackEnabled = true
+			};
+		case 1:
+			return {
+				.formula = QString("%1 * cos(2*pi*%2*x)").arg( dependency ).arg( frequency ),
+				.playbackEnabled = true
+			};
+		case 2:
+			return {
+				.formula = QString("s := 0.95*s + 0.05*%1; s").arg( dependency ),
+				.stateDescriptions = StateDescriptions{ { "s", StateDescription{ .size = 1 } } },
+				.playbackEnabled = true
+			};
+		default:
+			return {
+				.formula = (QStringList {
+					"var acc := 0;",
+					"for( var k:=1; k<=4; k+=1 ) {",
+					QString("  acc += cos( k*%1*2pi*x ) / k;").arg( frequency ),
+					"};",
+					QString("0.5*%1 + 0.1*acc;").arg( dependency )
+				}).join("\n"),
+				.playbackEnabled = true
+			};
+	}
+}
+
+void runStress(
+		Model* model,
+		const StressSettings& settings,
+		StressResults* results
+)
+{
+	std::mt19937 random( settings.seed );
+	model->resize( settings.minSize );
+	for( uint i=0; i<settings.minSize; i++ ) {
+		if( auto maybeError = model->bulkUpdate( i, randomUpdate( i, random ) ) ) {
+			results->errors << maybeError.value();
+		}
+	}
+
+	// audio:
+	const auto blockDuration = std::chrono::nanoseconds(
+			int64_t(1000000000) * settings.blockSize / settings.samplerate
+	);
+	std::atomic<bool> stopAudio = false;
+	std::thread audioThread([&]{
+		std::vector<float> buffer( settings.blockSize, 0 );
+		PlaybackPosition position = 0;
+		float last = 0;
+		auto next = Clock::now();
+		while( !stopAudio ) {
+			std::this_thread::sleep_until( next );
+			const auto t0 = Clock::now();
+			model->valuesToBuffer( &buffer, position, settings.samplerate );
+			position += buffer.size();
+			model->betweenAudio( position, settings.samplerate );
+			const auto t1 = Clock::now();
+			results->blockTimes.record( t1 - t0, blockDuration );
+			results->blocks++;
+			for( const auto sample : buffer ) {
+				if( !std::isfinite( sample ) ) {
+					results->nonFinite++;
+					continue;
+				}
+				if( std::abs( sample - last ) > settings.maxStep ) {
+					results->discontinuities++;
+				}
+				last = sample;
+			}
+			// a late block is an xrun,
+			// the sound server resyncs:
+			next += blockDuration;
+			if( t1 > next ) {
+				results->deadlineMisses++;
+				next = t1;
+			}
+		}
+	});
+	model->setAudioSchedulingEnabled( true );
+
+	// edits (playing the gui):
+	auto parameterEdits = std::make_shared<ParameterEdits>();
+	std::discrete_distribution<size_t> editDistribution(
+			settings.weights.begin(), settings.weights.end()
+	);
+	std::uniform_int_distribution<int64_t> pauseDistribution( 0, settings.maxPause.count() );
+	const auto end = Clock::now() + std::chrono::duration<double>( settings.duration );
+	while( Clock::now() < end ) {
+		const auto edit = Edit( editDistribution( random ) );
+		const auto size = model->size();
+		const auto index = std::uniform_int_distribution<uint>( 0, size-1 )( random );
+		const auto t0 = Clock::now();
+		MaybeError maybeError = {};
+		switch( edit ) {
+			case Edit::Formula:
+				maybeError = model->bulkUpdate( index, randomUpdate( index, random ) );
+			break;
+			case Edit::Parameter: {
+				{
+					std::scoped_lock lock( parameterEdits->lock );
+					parameterEdits->pending++;
+				}
+				const auto freq = std::uniform_real_distribution<double>( 110, 880 )( random );
+				const auto async = model->scheduleSetParameterValues(
+						0,
+						{ { "freq", C(freq, 0) } },
+						[parameterEdits,t0](auto, auto) {
+							std::scoped_lock lock( parameterEdits->lock );
+							parameterEdits->latencies.push_back( toMs( Clock::now() - t0 ) );
+							parameterEdits->pending--;
+							parameterEdits->done++;
+						}
+				);
+				if( async.empty() ) {
+					std::scoped_lock lock( parameterEdits->lock );
+					parameterEdits->pending--;
+					maybeError = "parameter 'freq' not ramped";
+				}
+			}
+			break;
+			case Edit::Resize: {
+				const auto newSize = std::uniform_int_distribution<uint>( settings.minSize, settings.maxSize )( random );
+				model->resize( newSize );
+				model->postSetAny();
+			}
+			break;
+			case Edit::Sampling: {
+				const auto resolution = std::array<uint,3>{ 0, 4410, 44100 }[ std::uniform_int_distribution<uint>( 0, 2 )( random ) ];
+				model->setSamplingSettings( index, SamplingSettings{
+						.resolution = resolution,
+						.interpolation = std::uniform_int_distribution<uint>( 0, 3 )( random ),
+						.periodic = T( std::uniform_int_distribution<uint>( 0, 1 )( random ) ),
+						.buffered = resolution > 0 && std::bernoulli_distribution( 0.5 )( random )
+				});
+			}
+			break;
+		}
+		if( edit != Edit::Parameter ) {
+			results->editLatencies[size_t(edit)].push_back( toMs( Clock::now() - t0 ) );
+		}
+		if( maybeError ) {
+			results->errors << QString("%1 edit of f%2: %3").arg( editName( edit ) ).arg( index ).arg( maybeError.value() );
+		}
+		// finished ramps, as the gui does:
+		{
+			std::unique_lock lock( parameterEdits->lock );
+			if( parameterEdits->done > 0 ) {
+				parameterEdits->done = 0;
+				lock.unlock();
+				model->postSetAny();
+			}
+		}
+		// redraw, as the gui does:
+		model->getGraph( std::min<uint>( index, model->size()-1 ), {0,1}, 1000 );
+		std::this_thread::sleep_for( std::chrono::milliseconds( pauseDistribution( random ) ) );
+	}
+
+	// wait for outstanding ramps:
+	const auto timeout = Clock::now() + 2s;
+	while( Clock::now() < timeout ) {
+		{
+			std::scoped_lock lock( parameterEdits->lock );
+			if( parameterEdits->pending == 0 ) {
+				break;
+			}
+		}
+		std::this_thread::sleep_for( 1ms );
+	}
+	model->postSetAny();
+	model->setAudioSchedulingEnabled( false );
+	stopAudio = true;
+	audioThread.join();
+
+	results->silentBlocks = model->getSilentBlockCount();
+	std::scoped_lock lock( parameterEdits->lock );
+	results->editLatencies[size_t(Edit::Parameter)] = parameterEdits->latencies;
+	results->unfinishedParameterEdits = parameterEdits->pending;
+}
+
+/* TEST */
+
+void TestStress::testConcurrentEdits_data() {
+	QTest::addColumn<EditWeights>("weights");
+	// formula, parameter, resize, sampling:
+	QTest::newRow("parameters") << EditWeights{ 0, 1, 0, 0 };
+	QTest::newRow("formulas") << EditWeights{ 1, 0, 0, 0 };
+	QTest::newRow("mixed") << EditWeights{ 2, 4, 1, 1 };
+}
+
+void TestStress::testConcurrentEdits() {
+	QFETCH(EditWeights, weights);
+	const StressSettings settings{
+		.duration = envOr( "FGE_STRESS_SECONDS", 2 ),
+		.seed = uint( envOr( "FGE_STRESS_SEED", 1 ) ),
+		.weights = weights
+	};
+	auto model = modelFactory();
+	StressResults results;
+	runStress( model.get(), settings, &results );
+
+	// report:
+	const auto blockTimes = results.blockTimes.percentiles();
+	qInfo().noquote() << QString("blocks: %1, deadline misses: %2, silent: %3, discontinuities: %4")
+		.arg( results.blocks )
+		.arg( results.deadlineMisses )
+		.arg( results.silentBlocks )
+		.arg( results.discontinuities );
+	qInfo().noquote() << QString("block time (x deadline) p50: %1, p99: %2, p99.9: %3")
+		.arg( blockTimes.p50 )
+		.arg( blockTimes.p99 )
+		.arg( blockTimes.p999 );
+	for( size_t i=0; i<editKindCount; i++ ) {
+		const auto& latencies = results.editLatencies[i];
+		if( latencies.empty() ) {
+			continue;
+		}
+		qInfo().noquote() << QString("%1 edits: %2, latency ms p50: %3, p90: %4, p99: %5, max: %6")
+			.arg( editName( Edit(i) ), -9 )
+			.arg( latencies.size() )
+			.arg( percentile( latencies, 0.5 ), 0, 'f', 1 )
+			.arg( percentile( latencies, 0.9 ), 0, 'f', 1 )
+			.arg( percentile( latencies, 0.99 ), 0, 'f', 1 )
+			.arg( percentile( latencies, 1 ), 0, 'f', 1 );
+	}
+
+	QVERIFY2( results.errors.isEmpty(), results.errors.join("\n").toStdString().c_str() );
+	QCOMPARE( results.nonFinite, uint64_t(0) );
+	QCOMPARE( results.unfinishedParameterEdits, uint64_t(0) );
+	// the audio thread kept running:
+	const auto expectedBlocks = settings.duration * settings.samplerate / settings.blockSize;
+	QVERIFY( double(results.blocks) > 0.5 * expectedBlocks );
+	const auto maxDeadlineMisses = envOr( "FGE_STRESS_MAX_DEADLINE_MISSES", -1 );
+	if( maxDeadlineMisses >= 0 ) {
+		QVERIFY( double(results.deadlineMisses) <= maxDeadlineMisses );
+	}
+}
@@ -0,0 +1,15 @@
+#ifndef TESTSTRESS_H
+#define TESTSTRESS_H
+
+#include <QTest>
+
+
+class TestStress: public QObject
+{
+	Q_OBJECT
+private slots:
+	void testConcurrentEdits_data();
+	void testConcurrentEdits();
+};
+
+#endif